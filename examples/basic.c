@@ -0,0 +1,133 @@
+#include <muntos/basic.h>
+#include <muntos/log.h>
+#include <muntos/muntos.h>
+#include <muntos/sem.h>
+#include <muntos/sleep.h>
+#include <muntos/task.h>
+
+#include <stdint.h>
+
+/*
+ * Three basic tasks share a host task that runs at priority 1 with a
+ * preemption threshold of 3. They are activated together each round, so they
+ * should run highest priority first, without interleaving, and only the task
+ * with priority 4 should be able to preempt them.
+ */
+
+#define NUM_ROUNDS 10
+#define BASIC_STACK_SIZE 1024
+
+static RT_SEM(round_done, 0);
+static RT_SEM(mid_sem, 0);
+static RT_SEM(urgent_sem, 0);
+
+static volatile bool failed = false;
+static volatile bool in_group = false;
+static volatile bool mid_ran = false;
+static volatile bool urgent_ran = false;
+static volatile unsigned num_rounds = 0;
+static unsigned order[3];
+static unsigned num_run = 0;
+
+static void enter(unsigned priority)
+{
+    if (in_group)
+    {
+        failed = true;
+    }
+    in_group = true;
+    order[num_run++ % 3] = priority;
+}
+
+static void high_fn(void)
+{
+    enter(3);
+    mid_ran = false;
+    urgent_ran = false;
+    rt_sem_post(&urgent_sem);
+    rt_sem_post(&mid_sem);
+    if (!urgent_ran || mid_ran)
+    {
+        failed = true;
+    }
+    in_group = false;
+}
+
+static void mid_fn(void)
+{
+    enter(2);
+    in_group = false;
+}
+
+static void low_fn(void)
+{
+    enter(1);
+    if ((order[0] != 3) || (order[1] != 2) || (order[2] != 1))
+    {
+        failed = true;
+    }
+    in_group = false;
+    rt_sem_post(&round_done);
+}
+
+static RT_BASIC_TASK(high, high_fn, 3, BASIC_STACK_SIZE);
+static RT_BASIC_TASK(mid, mid_fn, 2, BASIC_STACK_SIZE);
+static RT_BASIC_TASK(low, low_fn, 1, BASIC_STACK_SIZE);
+
+RT_BASIC_GROUP_STATIC(group, &low, &mid, &high);
+
+static void activator(void)
+{
+    rt_task_drop_privilege();
+    for (unsigned i = 0; i < NUM_ROUNDS; ++i)
+    {
+        /* Activate in reverse priority order. The host has lower priority
+         * than this task, so it only runs once all three are pending. */
+        rt_basic_task_activate(&group, &low);
+        rt_basic_task_activate(&group, &mid);
+        rt_basic_task_activate(&group, &high);
+        rt_sem_wait(&round_done);
+        num_rounds = i + 1;
+    }
+    rt_stop();
+}
+
+static void middle(void)
+{
+    rt_task_drop_privilege();
+    for (;;)
+    {
+        rt_sem_wait(&mid_sem);
+        mid_ran = true;
+    }
+}
+
+static void urgent(void)
+{
+    rt_task_drop_privilege();
+    for (;;)
+    {
+        rt_sem_wait(&urgent_sem);
+        urgent_ran = true;
+    }
+}
+
+int main(void)
+{
+    RT_TASK_ARG_THRESHOLD(rt_basic_group_run, (uintptr_t)&group,
+                          RT_STACK_MIN + BASIC_STACK_SIZE, 1, 3);
+    RT_TASK(activator, RT_STACK_MIN, 2);
+    RT_TASK(middle, RT_STACK_MIN, 2);
+    RT_TASK(urgent, RT_STACK_MIN, 4);
+    rt_start();
+
+    const size_t stack_size = rt_basic_group_stack_size(&group);
+    rt_logf("group stack size %zu, separate stacks would need %zu\n",
+            stack_size, 3 * (size_t)(RT_STACK_MIN + BASIC_STACK_SIZE));
+
+    if (failed || (num_rounds != NUM_ROUNDS) ||
+        (stack_size > RT_STACK_MIN + BASIC_STACK_SIZE))
+    {
+        return 1;
+    }
+}
@@ -0,0 +1,111 @@
+#include <muntos/broadcast.h>
+#include <muntos/log.h>
+#include <muntos/muntos.h>
+#include <muntos/sleep.h>
+#include <muntos/task.h>
+
+#include <stdint.h>
+
+#define NUM_READERS 3
+
+RT_BROADCAST_STATIC(reliable, uint32_t, 4, RT_BROADCAST_BLOCK);
+RT_BROADCAST_STATIC(lossy, uint32_t, 4, RT_BROADCAST_OVERWRITE);
+
+static void publisher(uintptr_t arg)
+{
+    rt_task_drop_privilege();
+    struct rt_broadcast *const bc = (struct rt_broadcast *)arg;
+    for (uint32_t seq = 0;; ++seq)
+    {
+        rt_broadcast_publish(bc, &seq);
+    }
+}
+
+static volatile bool failed = false;
+static volatile uint32_t num_read[NUM_READERS];
+
+static void reader(uintptr_t i)
+{
+    rt_task_drop_privilege();
+    struct rt_broadcast_sub sub;
+    rt_broadcast_subscribe(&reliable, &sub);
+    uint32_t prev;
+    rt_broadcast_read(&sub, &prev);
+    for (;;)
+    {
+        uint32_t seq;
+        if ((prev % 2) == 0)
+        {
+            rt_broadcast_read(&sub, &seq);
+        }
+        else if (!rt_broadcast_timedread(&sub, &seq, 10))
+        {
+            continue;
+        }
+        /* Every reader must see every message on a blocking channel. */
+        if ((seq != prev + 1) || (rt_broadcast_lost(&sub) != 0))
+        {
+            failed = true;
+        }
+        prev = seq;
+        ++num_read[i];
+    }
+}
+
+static volatile unsigned long num_lost = 0;
+
+static void slow_reader(void)
+{
+    rt_task_drop_privilege();
+    struct rt_broadcast_sub sub;
+    rt_broadcast_subscribe(&lossy, &sub);
+    uint32_t prev;
+    rt_broadcast_read(&sub, &prev);
+    for (;;)
+    {
+        rt_sleep(1);
+        const unsigned long lost = rt_broadcast_lost(&sub);
+        uint32_t seq;
+        rt_broadcast_read(&sub, &seq);
+        /* Messages can be skipped, but only those counted as lost. */
+        if (seq != prev + 1 + (rt_broadcast_lost(&sub) - lost))
+        {
+            failed = true;
+        }
+        prev = seq;
+        num_lost = rt_broadcast_lost(&sub);
+    }
+}
+
+static void timeout(void)
+{
+    rt_sleep(1000);
+    rt_stop();
+}
+
+int main(void)
+{
+    RT_TASK_ARG(publisher, (uintptr_t)&reliable, RT_STACK_MIN, 1);
+    RT_TASK_ARG(publisher, (uintptr_t)&lossy, RT_STACK_MIN, 1);
+    RT_TASK_ARG(reader, 0, RT_STACK_MIN, 2);
+    RT_TASK_ARG(reader, 1, RT_STACK_MIN, 2);
+    RT_TASK_ARG(reader, 2, RT_STACK_MIN, 2);
+    RT_TASK(slow_reader, RT_STACK_MIN, 2);
+    RT_TASK(timeout, RT_STACK_MIN, 3);
+    rt_start();
+
+    for (int i = 0; i < NUM_READERS; ++i)
+    {
+        rt_logf("reader %d read %u messages\n", i, (unsigned)num_read[i]);
+        if (num_read[i] == 0)
+        {
+            failed = true;
+        }
+    }
+    rt_logf("slow reader lost %lu messages\n", num_lost);
+
+    if (failed || (num_lost == 0))
+    {
+        return 1;
+    }
+}
@@ -0,0 +1,166 @@
+#include <muntos/container.h>
+#include <muntos/coro.h>
+#include <muntos/log.h>
+#include <muntos/muntos.h>
+#include <muntos/queue.h>
+#include <muntos/sem.h>
+#include <muntos/sleep.h>
+#include <muntos/task.h>
+#include <muntos/tick.h>
+
+#include <stdint.h>
+
+/*
+ * A token is passed around a ring of coroutines, each waiting on its own
+ * semaphore, while another coroutine relays items between two tasks through
+ * queues, and another sleeps periodically.
+ */
+
+#define NUM_RING 200
+#define NUM_LAPS 10
+#define NUM_ITEMS 100
+#define NUM_SLEEPS 10
+#define SLEEP_TICKS 5
+
+RT_CORO_HOST_STATIC(host, NUM_RING + 2);
+
+struct ring
+{
+    struct rt_coro coro;
+    struct rt_sem sem;
+    unsigned laps;
+};
+
+static struct ring rings[NUM_RING];
+
+static void ring_fn(struct rt_coro *coro)
+{
+    struct ring *const r = rt_container_of(coro, struct ring, coro);
+    struct ring *const next = &rings[(size_t)(r - rings + 1) % NUM_RING];
+    RT_CORO_BEGIN(coro);
+    while (r->laps < NUM_LAPS)
+    {
+        RT_CORO_SEM_WAIT(coro, &r->sem);
+        ++r->laps;
+        rt_sem_post(&next->sem);
+    }
+    RT_CORO_END(coro);
+}
+
+RT_QUEUE_STATIC(in, unsigned, 4);
+RT_QUEUE_STATIC(out, unsigned, 4);
+
+static unsigned relay_item, num_relayed = 0;
+
+static void relay_fn(struct rt_coro *coro)
+{
+    RT_CORO_BEGIN(coro);
+    while (num_relayed < NUM_ITEMS)
+    {
+        RT_CORO_QUEUE_POP(coro, &in, &relay_item);
+        RT_CORO_QUEUE_PUSH(coro, &out, &relay_item);
+        ++num_relayed;
+    }
+    RT_CORO_END(coro);
+}
+
+static RT_CORO(relay, relay_fn);
+
+static unsigned num_sleeps = 0;
+static unsigned long sleep_start, sleep_end;
+
+static void sleeper_fn(struct rt_coro *coro)
+{
+    RT_CORO_BEGIN(coro);
+    sleep_start = rt_tick();
+    while (num_sleeps < NUM_SLEEPS)
+    {
+        RT_CORO_SLEEP(coro, SLEEP_TICKS);
+        ++num_sleeps;
+    }
+    sleep_end = rt_tick();
+    RT_CORO_END(coro);
+}
+
+static RT_CORO(sleeper, sleeper_fn);
+
+static void producer(void)
+{
+    rt_task_drop_privilege();
+    for (unsigned i = 0; i < NUM_ITEMS; ++i)
+    {
+        rt_queue_push(&in, &i);
+    }
+}
+
+static volatile bool failed = false;
+static volatile unsigned num_consumed = 0;
+
+static void consumer(void)
+{
+    rt_task_drop_privilege();
+    for (unsigned i = 0; i < NUM_ITEMS; ++i)
+    {
+        unsigned item;
+        rt_queue_pop(&out, &item);
+        if (item != i)
+        {
+            failed = true;
+        }
+        num_consumed = i + 1;
+    }
+}
+
+static void timeout(void)
+{
+    rt_sleep(1000);
+    rt_stop();
+}
+
+int main(void)
+{
+    for (size_t i = 0; i < NUM_RING; ++i)
+    {
+        rt_coro_init(&rings[i].coro, ring_fn, "ring");
+        /* The first coroutine starts with the token. */
+        rt_sem_init_binary(&rings[i].sem, (i == 0) ? 1 : 0);
+        rings[i].laps = 0;
+        rt_coro_host_add(&host, &rings[i].coro);
+        if (!rt_coro_host_add_sem(&host, &rings[i].sem))
+        {
+            return 1;
+        }
+    }
+    rt_coro_host_add(&host, &relay);
+    rt_coro_host_add(&host, &sleeper);
+    /* The relay only pops from in and pushes to out, so the tasks keep the
+     * other side of each queue. */
+    if (!rt_coro_host_add_queue_pop(&host, &in) ||
+        !rt_coro_host_add_queue_push(&host, &out))
+    {
+        return 1;
+    }
+
+    RT_TASK_ARG(rt_coro_host_run, (uintptr_t)&host, RT_STACK_MIN, 1);
+    RT_TASK(producer, RT_STACK_MIN, 1);
+    RT_TASK(consumer, RT_STACK_MIN, 1);
+    RT_TASK(timeout, RT_STACK_MIN, 2);
+    rt_start();
+
+    rt_logf("%d coroutines use %zu bytes, tasks would use at least %zu\n",
+            NUM_RING, sizeof rings,
+            (size_t)NUM_RING * (sizeof(struct rt_task) + RT_STACK_MIN));
+
+    for (size_t i = 0; i < NUM_RING; ++i)
+    {
+        if (rings[i].laps != NUM_LAPS)
+        {
+            return 1;
+        }
+    }
+    if (failed || (num_consumed != NUM_ITEMS) || (num_sleeps != NUM_SLEEPS) ||
+        ((sleep_end - sleep_start) < (NUM_SLEEPS * SLEEP_TICKS)))
+    {
+        return 1;
+    }
+}
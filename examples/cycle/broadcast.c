@@ -0,0 +1,68 @@
+#include <muntos/cond.h>
+#include <muntos/cycle.h>
+#include <muntos/log.h>
+#include <muntos/muntos.h>
+#include <muntos/mutex.h>
+#include <muntos/task.h>
+
+#define NUM_WAITERS 64
+
+static volatile uint32_t start_cycle = 0;
+static volatile uint32_t cycles = 0;
+
+static RT_MUTEX(mutex);
+static RT_COND(cond);
+static bool ready = false;
+static int num_woken = 0;
+
+static void waiter(uintptr_t arg)
+{
+    (void)arg;
+    rt_mutex_lock(&mutex);
+    while (!ready)
+    {
+        rt_cond_wait(&cond, &mutex);
+    }
+    /* The first waiter to run measures the cost of waking all of them. */
+    if (num_woken == 0)
+    {
+        cycles = rt_cycle() - start_cycle;
+    }
+    ++num_woken;
+    if (num_woken == NUM_WAITERS)
+    {
+        rt_stop();
+    }
+    rt_mutex_unlock(&mutex);
+}
+
+static void broadcaster(void)
+{
+    rt_mutex_lock(&mutex);
+    ready = true;
+    start_cycle = rt_cycle();
+    rt_cond_broadcast(&cond);
+    rt_mutex_unlock(&mutex);
+}
+
+RT_STACKS(waiter_stacks, RT_STACK_MIN, NUM_WAITERS);
+static struct rt_task waiters[NUM_WAITERS];
+
+int main(void)
+{
+    /* Spread the waiters over several priorities so that waking them merges
+     * them into the ready list rather than only appending them. All of them
+     * are higher priority than the broadcaster, so they are all waiting when
+     * it runs. */
+    for (uintptr_t i = 0; i < NUM_WAITERS; ++i)
+    {
+        rt_task_init_arg(&waiters[i], waiter, i, "waiter",
+                         2 + (unsigned)(i % 4), waiter_stacks[i],
+                         RT_STACK_MIN);
+    }
+    RT_TASK(broadcaster, RT_STACK_MIN, 1);
+
+    rt_start();
+
+    rt_logf("cycles = %u\n", (unsigned)cycles);
+}
@@ -3,16 +3,25 @@
 #include <muntos/notify.h>
 #include <muntos/muntos.h>
 #include <muntos/task.h>
+#include <muntos/task_notify.h>
 
 static volatile uint32_t start_cycle = 0;
 static volatile uint32_t cycles = 0;
+static volatile uint32_t task_cycles = 0;
 
 static RT_NOTIFY(note, 0);
 
+static struct rt_task *volatile waiter_self = NULL;
+
 static void waiter(void)
 {
+    waiter_self = rt_task_self();
+
     rt_notify_wait(&note);
     cycles = rt_cycle() - start_cycle;
+
+    rt_task_notify_wait();
+    task_cycles = rt_cycle() - start_cycle;
     rt_stop();
 }
 
@@ -20,6 +29,9 @@ static void poster(void)
 {
     start_cycle = rt_cycle();
     rt_notify(&note);
+
+    start_cycle = rt_cycle();
+    rt_task_notify(waiter_self);
 }
 
 int main(void)
@@ -30,4 +42,9 @@ int main(void)
     rt_start();
 
     rt_logf("cycles = %u\n", (unsigned)cycles);
+    rt_logf("task notify cycles = %u\n", (unsigned)task_cycles);
+    rt_logf("sizeof(struct rt_notify) = %zu\n", sizeof(struct rt_notify));
+    /* Task notifications add notify_value and notify_state to every task,
+     * which is why they must be enabled with RT_TASK_ENABLE_NOTIFY. */
+    rt_logf("sizeof(struct rt_task) = %zu\n", sizeof(struct rt_task));
 }
@@ -0,0 +1,38 @@
+#include <muntos/cycle.h>
+#include <muntos/log.h>
+#include <muntos/muntos.h>
+#include <muntos/rcu.h>
+#include <muntos/rwlock.h>
+#include <muntos/task.h>
+
+static RT_RWLOCK(lock);
+
+static volatile uint32_t rcu_cycles = 0;
+static volatile uint32_t rwlock_cycles = 0;
+
+static void task(void)
+{
+    /* Without a writer, neither read side enters the kernel, but only the
+     * rwlock makes atomic read-modify-writes. */
+    uint32_t start_cycle = rt_cycle();
+    rt_rcu_read_lock();
+    rt_rcu_read_unlock();
+    rcu_cycles = rt_cycle() - start_cycle;
+
+    start_cycle = rt_cycle();
+    rt_rwlock_rlock(&lock);
+    rt_rwlock_runlock(&lock);
+    rwlock_cycles = rt_cycle() - start_cycle;
+
+    rt_stop();
+}
+
+int main(void)
+{
+    RT_TASK(task, RT_STACK_MIN, 1);
+
+    rt_start();
+
+    rt_logf("rcu read cycles = %u\n", (unsigned)rcu_cycles);
+    rt_logf("rwlock read cycles = %u\n", (unsigned)rwlock_cycles);
+}
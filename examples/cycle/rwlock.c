@@ -0,0 +1,36 @@
+#include <muntos/cycle.h>
+#include <muntos/log.h>
+#include <muntos/muntos.h>
+#include <muntos/rwlock.h>
+#include <muntos/task.h>
+
+static RT_RWLOCK(lock);
+
+static volatile uint32_t rcycles = 0;
+static volatile uint32_t wcycles = 0;
+
+static void task(void)
+{
+    /* Without contention, neither locking nor unlocking enters the kernel. */
+    uint32_t start_cycle = rt_cycle();
+    rt_rwlock_rlock(&lock);
+    rt_rwlock_runlock(&lock);
+    rcycles = rt_cycle() - start_cycle;
+
+    start_cycle = rt_cycle();
+    rt_rwlock_wlock(&lock);
+    rt_rwlock_wunlock(&lock);
+    wcycles = rt_cycle() - start_cycle;
+
+    rt_stop();
+}
+
+int main(void)
+{
+    RT_TASK(task, RT_STACK_MIN, 1);
+
+    rt_start();
+
+    rt_logf("read cycles = %u\n", (unsigned)rcycles);
+    rt_logf("write cycles = %u\n", (unsigned)wcycles);
+}
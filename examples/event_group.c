@@ -0,0 +1,134 @@
+#include <muntos/event_group.h>
+#include <muntos/log.h>
+#include <muntos/muntos.h>
+#include <muntos/sleep.h>
+#include <muntos/task.h>
+
+#include <stdint.h>
+
+#define ALL_BITS UINT32_C(0x07)
+#define ANY_BITS UINT32_C(0x18)
+#define START_BIT UINT32_C(0x20)
+#define STOP_BIT UINT32_C(0x40)
+#define NEVER_BIT UINT32_C(0x100)
+
+static RT_EVENT_GROUP(group, 0);
+
+static void setter(void)
+{
+    rt_task_drop_privilege();
+    for (uint32_t i = 0;; ++i)
+    {
+        rt_event_group_set(&group, UINT32_C(1) << (i % 3));
+        rt_event_group_set(&group, UINT32_C(0x08) << (i % 2));
+        if ((i % 8) == 0)
+        {
+            rt_event_group_clear(&group, STOP_BIT);
+            rt_event_group_set(&group, START_BIT);
+        }
+        else if ((i % 8) == 4)
+        {
+            rt_event_group_clear(&group, START_BIT);
+            rt_event_group_set(&group, STOP_BIT);
+        }
+        rt_sleep(1);
+    }
+}
+
+static volatile bool failed = false;
+static volatile uint32_t num_all = 0, num_any = 0, num_timeouts = 0;
+static volatile uint32_t num_started[2];
+
+static void all_waiter(void)
+{
+    rt_task_drop_privilege();
+    for (;;)
+    {
+        const uint32_t bits = rt_event_group_wait(
+            &group, ALL_BITS, RT_EVENT_GROUP_WAIT_ALL | RT_EVENT_GROUP_CLEAR);
+        if ((bits & ALL_BITS) != ALL_BITS)
+        {
+            failed = true;
+        }
+        ++num_all;
+    }
+}
+
+static void any_waiter(void)
+{
+    rt_task_drop_privilege();
+    for (;;)
+    {
+        uint32_t bits;
+        if (!rt_event_group_timedwait(&group, ANY_BITS, RT_EVENT_GROUP_CLEAR,
+                                      &bits, 100) ||
+            ((bits & ANY_BITS) == 0))
+        {
+            failed = true;
+        }
+        ++num_any;
+    }
+}
+
+/*
+ * Two tasks wait for the same bits without clearing them, so each set of
+ * START_BIT should wake both of them.
+ */
+static void start_waiter(uintptr_t i)
+{
+    rt_task_drop_privilege();
+    for (;;)
+    {
+        rt_event_group_wait(&group, START_BIT, 0);
+        ++num_started[i];
+        rt_event_group_wait(&group, STOP_BIT, 0);
+    }
+}
+
+static void timeout_waiter(void)
+{
+    rt_task_drop_privilege();
+    for (;;)
+    {
+        uint32_t bits;
+        if (rt_event_group_timedwait(&group, NEVER_BIT | ALL_BITS,
+                                     RT_EVENT_GROUP_WAIT_ALL |
+                                         RT_EVENT_GROUP_CLEAR,
+                                     &bits, 5))
+        {
+            failed = true;
+        }
+        ++num_timeouts;
+    }
+}
+
+static void timeout(void)
+{
+    rt_sleep(1000);
+    rt_stop();
+}
+
+int main(void)
+{
+    RT_TASK(setter, RT_STACK_MIN, 1);
+    RT_TASK(all_waiter, RT_STACK_MIN, 2);
+    RT_TASK(any_waiter, RT_STACK_MIN, 2);
+    RT_TASK_ARG(start_waiter, 0, RT_STACK_MIN, 2);
+    RT_TASK_ARG(start_waiter, 1, RT_STACK_MIN, 3);
+    RT_TASK(timeout_waiter, RT_STACK_MIN, 3);
+    RT_TASK(timeout, RT_STACK_MIN, 4);
+    rt_start();
+
+    rt_logf("all %u, any %u, started %u/%u, timeouts %u\n", (unsigned)num_all,
+            (unsigned)num_any, (unsigned)num_started[0],
+            (unsigned)num_started[1], (unsigned)num_timeouts);
+
+    const uint32_t started_diff = (num_started[0] > num_started[1])
+                                      ? (num_started[0] - num_started[1])
+                                      : (num_started[1] - num_started[0]);
+    if (failed || (num_all == 0) || (num_any == 0) || (num_started[0] == 0) ||
+        (started_diff > 1) || (num_timeouts == 0))
+    {
+        return 1;
+    }
+}
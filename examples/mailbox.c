@@ -0,0 +1,86 @@
+#include <muntos/mailbox.h>
+#include <muntos/muntos.h>
+#include <muntos/sleep.h>
+#include <muntos/task.h>
+
+#include <stdint.h>
+
+/*
+ * A writer sends bursts of setpoints faster than the reader takes them, and
+ * the reader only ever sees the newest one.
+ */
+
+#define NUM_BURSTS 10
+#define BURST_SIZE 20
+
+struct setpoint
+{
+    uint32_t value, check;
+};
+
+RT_MAILBOX_STATIC(mailbox, struct setpoint);
+
+static void writer(void)
+{
+    rt_task_drop_privilege();
+    uint32_t value = 0;
+    for (int i = 0; i < NUM_BURSTS; ++i)
+    {
+        rt_sleep(5);
+        for (int j = 0; j < BURST_SIZE; ++j)
+        {
+            ++value;
+            const struct setpoint sp = {.value = value, .check = ~value};
+            rt_mailbox_write(&mailbox, &sp);
+        }
+    }
+}
+
+static volatile bool failed = false;
+
+static void reader(void)
+{
+    rt_task_drop_privilege();
+    struct setpoint sp;
+
+    if (rt_mailbox_read(&mailbox, &sp) || (sp.value != 0) ||
+        rt_mailbox_tryread(&mailbox, &sp))
+    {
+        failed = true;
+    }
+
+    for (uint32_t i = 1; i <= NUM_BURSTS; ++i)
+    {
+        /* The writer has a higher priority than the reader, so each burst
+         * completes before the reader runs again. */
+        rt_mailbox_wait(&mailbox, &sp);
+        if ((sp.value != i * BURST_SIZE) || (sp.check != ~sp.value))
+        {
+            failed = true;
+        }
+        if (rt_mailbox_read(&mailbox, &sp) || (sp.value != i * BURST_SIZE))
+        {
+            failed = true;
+        }
+    }
+
+    if (rt_mailbox_timedwait(&mailbox, &sp, 10))
+    {
+        failed = true;
+    }
+
+    rt_stop();
+}
+
+int main(void)
+{
+    RT_TASK(writer, RT_STACK_MIN, 2);
+    RT_TASK(reader, RT_STACK_MIN, 1);
+
+    rt_start();
+
+    if (failed)
+    {
+        return 1;
+    }
+}
@@ -0,0 +1,139 @@
+#include <muntos/log.h>
+#include <muntos/message_buffer.h>
+#include <muntos/muntos.h>
+#include <muntos/sleep.h>
+#include <muntos/task.h>
+
+#include <stdint.h>
+
+#define ARENA_SIZE 512
+#define MAX_LEN RT_MESSAGE_BUFFER_MAX_LEN(ARENA_SIZE)
+
+RT_MESSAGE_BUFFER_STATIC(buffer, ARENA_SIZE);
+
+/* Vary the message length with the sequence number. */
+static size_t message_len(uint32_t seq)
+{
+    return 8 + ((seq * 29) % (MAX_LEN - 7));
+}
+
+static void sender(void)
+{
+    rt_task_drop_privilege();
+    static unsigned char msg[MAX_LEN];
+    for (uint32_t seq = 0;; ++seq)
+    {
+        const size_t len = message_len(seq);
+        for (size_t i = 0; i < len; ++i)
+        {
+            msg[i] = (unsigned char)(seq + i);
+        }
+        switch (seq % 3)
+        {
+        case 0:
+            rt_message_buffer_send(&buffer, msg, len);
+            break;
+        case 1:
+            while (!rt_message_buffer_trysend(&buffer, msg, len))
+            {
+                rt_sleep(1);
+            }
+            break;
+        default:
+            while (!rt_message_buffer_timedsend(&buffer, msg, len, 1))
+            {
+            }
+            break;
+        }
+    }
+}
+
+static volatile bool failed = false;
+static volatile uint32_t num_received = 0;
+
+static bool valid(const unsigned char *msg, size_t len, uint32_t seq)
+{
+    if (len != message_len(seq))
+    {
+        return false;
+    }
+    for (size_t i = 0; i < len; ++i)
+    {
+        if (msg[i] != (unsigned char)(seq + i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void receiver(void)
+{
+    rt_task_drop_privilege();
+    static unsigned char msg[MAX_LEN];
+    for (uint32_t seq = 0;; ++seq)
+    {
+        size_t len;
+        switch (seq % 4)
+        {
+        case 0:
+            len = rt_message_buffer_receive(&buffer, msg, sizeof msg);
+            break;
+        case 1:
+            while (!rt_message_buffer_tryreceive(&buffer, msg, sizeof msg,
+                                                 &len))
+            {
+                rt_sleep(1);
+            }
+            break;
+        case 2:
+            while (!rt_message_buffer_timedreceive(&buffer, msg, sizeof msg,
+                                                   &len, 1))
+            {
+            }
+            break;
+        default:
+        {
+            /* Check the message in place, then discard it. */
+            const unsigned char *const p =
+                rt_message_buffer_peek(&buffer, &len);
+            if (!valid(p, len, seq))
+            {
+                failed = true;
+            }
+            if (rt_message_buffer_receive(&buffer, msg, 0) != len)
+            {
+                failed = true;
+            }
+            num_received = seq + 1;
+            continue;
+        }
+        }
+        if (!valid(msg, len, seq))
+        {
+            failed = true;
+        }
+        num_received = seq + 1;
+    }
+}
+
+static void timeout(void)
+{
+    rt_sleep(1000);
+    rt_stop();
+}
+
+int main(void)
+{
+    RT_TASK(sender, RT_STACK_MIN, 1);
+    RT_TASK(receiver, RT_STACK_MIN, 1);
+    RT_TASK(timeout, RT_STACK_MIN, 2);
+    rt_start();
+
+    rt_logf("received %u messages\n", (unsigned)num_received);
+
+    if (failed || (num_received == 0))
+    {
+        return 1;
+    }
+}
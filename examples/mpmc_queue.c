@@ -0,0 +1,151 @@
+#include <muntos/atomic.h>
+#include <muntos/mpmc_queue.h>
+#include <muntos/muntos.h>
+#include <muntos/sem.h>
+#include <muntos/sleep.h>
+#include <muntos/task.h>
+
+#include <stdint.h>
+
+/*
+ * Several producers push bursts of messages without ever blocking, dropping
+ * messages when the node pool is exhausted, while several consumers pop them.
+ * Every message pushed must be popped exactly once.
+ */
+
+#define NUM_PRODUCERS 3
+#define NUM_CONSUMERS 3
+#define NUM_BURSTS 20
+#define BURST_SIZE 16
+#define QUEUE_SIZE 32
+
+struct message
+{
+    uint32_t producer, seq;
+};
+
+RT_MPMC_QUEUE_STATIC(queue, struct message, QUEUE_SIZE);
+
+/* The pool has QUEUE_SIZE + 1 nodes, so the links need 6 index bits and the
+ * rest of each link is tag. */
+static_assert(RT_MPMC_QUEUE_INDEX_BITS_FOR(QUEUE_SIZE) == 6,
+              "unexpected index bits");
+
+static volatile uint32_t pushed[NUM_PRODUCERS];
+static volatile uint32_t dropped = 0;
+
+static RT_SEM(done_sem, 0);
+
+static void producer(uintptr_t id)
+{
+    rt_task_drop_privilege();
+    uint32_t seq = 0;
+    for (int i = 0; i < NUM_BURSTS; ++i)
+    {
+        for (int j = 0; j < BURST_SIZE; ++j)
+        {
+            const struct message msg = {.producer = (uint32_t)id, .seq = seq};
+            if (rt_mpmc_queue_push(&queue, &msg))
+            {
+                ++seq;
+            }
+            else
+            {
+                ++dropped;
+            }
+        }
+        rt_sleep(1);
+    }
+    pushed[id] = seq;
+    rt_sem_post(&done_sem);
+}
+
+#define MAX_SEQ (NUM_BURSTS * BURST_SIZE)
+
+static rt_atomic_uchar times_popped[NUM_PRODUCERS][MAX_SEQ];
+static rt_atomic_uint popped = 0;
+static volatile bool failed = false;
+
+static void consumer(void)
+{
+    rt_task_drop_privilege();
+    for (;;)
+    {
+        struct message msg;
+        rt_mpmc_queue_pop(&queue, &msg);
+        if ((msg.producer >= NUM_PRODUCERS) || (msg.seq >= MAX_SEQ) ||
+            (rt_atomic_fetch_add_explicit(&times_popped[msg.producer][msg.seq],
+                                          1, memory_order_relaxed) != 0))
+        {
+            failed = true;
+        }
+        rt_atomic_fetch_add_explicit(&popped, 1, memory_order_relaxed);
+    }
+}
+
+static void checker(void)
+{
+    rt_task_drop_privilege();
+    for (int i = 0; i < NUM_PRODUCERS; ++i)
+    {
+        rt_sem_wait(&done_sem);
+    }
+    rt_sleep(10);
+
+    uint32_t total = 0;
+    for (int i = 0; i < NUM_PRODUCERS; ++i)
+    {
+        total += pushed[i];
+    }
+    struct message msg;
+    if ((rt_atomic_load_explicit(&popped, memory_order_relaxed) != total) ||
+        rt_mpmc_queue_trypop(&queue, &msg) ||
+        rt_mpmc_queue_timedpop(&queue, &msg, 5))
+    {
+        failed = true;
+    }
+
+    /* The consumers have a lower priority, so they don't run until this
+     * task stops, and the pool holds exactly QUEUE_SIZE messages. */
+    msg.producer = 0;
+    msg.seq = 0;
+    for (uint32_t i = 0; i < QUEUE_SIZE; ++i)
+    {
+        if (!rt_mpmc_queue_push(&queue, &msg))
+        {
+            failed = true;
+        }
+    }
+    if (rt_mpmc_queue_push(&queue, &msg))
+    {
+        failed = true;
+    }
+    rt_stop();
+}
+
+int main(void)
+{
+    RT_STACKS(producer_stacks, RT_STACK_MIN, NUM_PRODUCERS);
+    static struct rt_task producers[NUM_PRODUCERS];
+    for (uintptr_t i = 0; i < NUM_PRODUCERS; ++i)
+    {
+        rt_task_init_arg(&producers[i], producer, i, "producer", 2,
+                         producer_stacks[i], RT_STACK_MIN);
+    }
+
+    RT_STACKS(consumer_stacks, RT_STACK_MIN, NUM_CONSUMERS);
+    static struct rt_task consumers[NUM_CONSUMERS];
+    for (int i = 0; i < NUM_CONSUMERS; ++i)
+    {
+        rt_task_init(&consumers[i], consumer, "consumer", 1,
+                     consumer_stacks[i], RT_STACK_MIN);
+    }
+
+    RT_TASK(checker, RT_STACK_MIN, 2);
+    rt_start();
+
+    if (failed || (dropped == 0))
+    {
+        return 1;
+    }
+}
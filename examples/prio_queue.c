@@ -0,0 +1,114 @@
+#include <muntos/muntos.h>
+#include <muntos/prio_queue.h>
+#include <muntos/queue.h>
+#include <muntos/sleep.h>
+#include <muntos/task.h>
+
+#include <stdint.h>
+
+/*
+ * An urgent command pushed behind a backlog of bulk messages is popped first,
+ * and messages of the same priority are popped in order.
+ */
+
+#define NUM_BULK 100
+#define NUM_COMMANDS 4
+
+enum priority
+{
+    PRIORITY_BULK,
+    PRIORITY_NORMAL,
+    PRIORITY_URGENT,
+};
+
+RT_QUEUE_STATIC(bulk, uint32_t, NUM_BULK);
+RT_QUEUE_STATIC(normal, uint32_t, NUM_COMMANDS);
+RT_QUEUE_STATIC(urgent, uint32_t, NUM_COMMANDS);
+
+RT_PRIO_QUEUE_STATIC(queue, &bulk, &normal, &urgent);
+
+#define URGENT_BASE 1000U
+#define NORMAL_BASE 2000U
+
+static volatile bool failed = false;
+
+static void producer(void)
+{
+    rt_task_drop_privilege();
+    for (uint32_t i = 0; i < NUM_BULK; ++i)
+    {
+        rt_prio_queue_push(&queue, PRIORITY_BULK, &i);
+    }
+    for (uint32_t i = 0; i < NUM_COMMANDS; ++i)
+    {
+        const uint32_t normal_msg = NORMAL_BASE + i;
+        rt_prio_queue_push(&queue, PRIORITY_NORMAL, &normal_msg);
+        const uint32_t urgent_msg = URGENT_BASE + i;
+        rt_prio_queue_push(&queue, PRIORITY_URGENT, &urgent_msg);
+    }
+
+    /* The bulk level is full, but other levels aren't. */
+    const uint32_t x = 0;
+    if (rt_prio_queue_trypush(&queue, PRIORITY_BULK, &x) ||
+        rt_prio_queue_timedpush(&queue, PRIORITY_BULK, &x, 5))
+    {
+        failed = true;
+    }
+
+    /* A priority above the highest level goes to the urgent level, which is
+     * also full. */
+    if (rt_prio_queue_trypush(&queue, PRIORITY_URGENT + 1, &x))
+    {
+        failed = true;
+    }
+}
+
+static void consumer(void)
+{
+    rt_task_drop_privilege();
+    /* Let the producer fill the queue. */
+    rt_sleep(20);
+
+    uint32_t msg;
+    for (uint32_t i = 0; i < NUM_COMMANDS; ++i)
+    {
+        if (!rt_prio_queue_trypop(&queue, &msg) || (msg != URGENT_BASE + i))
+        {
+            failed = true;
+        }
+    }
+    for (uint32_t i = 0; i < NUM_COMMANDS; ++i)
+    {
+        rt_prio_queue_pop(&queue, &msg);
+        if (msg != NORMAL_BASE + i)
+        {
+            failed = true;
+        }
+    }
+    for (uint32_t i = 0; i < NUM_BULK; ++i)
+    {
+        if (!rt_prio_queue_timedpop(&queue, &msg, 5) || (msg != i))
+        {
+            failed = true;
+        }
+    }
+    if (rt_prio_queue_trypop(&queue, &msg) ||
+        rt_prio_queue_timedpop(&queue, &msg, 5))
+    {
+        failed = true;
+    }
+    rt_stop();
+}
+
+int main(void)
+{
+    RT_TASK(producer, RT_STACK_MIN, 1);
+    RT_TASK(consumer, RT_STACK_MIN, 1);
+
+    rt_start();
+
+    if (failed)
+    {
+        return 1;
+    }
+}
@@ -0,0 +1,104 @@
+#include <muntos/log.h>
+#include <muntos/muntos.h>
+#include <muntos/sem.h>
+#include <muntos/sleep.h>
+#include <muntos/task.h>
+
+#include <stdint.h>
+
+#define NUM_WAITERS 3
+
+static RT_SEM(sem, 0);
+static RT_SEM(low_sem, 0);
+
+static volatile bool failed = false;
+static volatile bool low_ran = false;
+static uintptr_t wake_order[NUM_WAITERS];
+static size_t num_woken = 0;
+
+static void waiter(uintptr_t arg)
+{
+    rt_sem_wait(&sem);
+    wake_order[num_woken++] = arg;
+}
+
+static void low(void)
+{
+    for (;;)
+    {
+        rt_sem_wait(&low_sem);
+        low_ran = true;
+    }
+}
+
+RT_STACKS(waiter_stacks, RT_STACK_MIN, NUM_WAITERS);
+static struct rt_task waiters[NUM_WAITERS];
+RT_STACK(low_stack, RT_STACK_MIN);
+static struct rt_task low_task;
+
+static void manager(void)
+{
+    /* Let the waiters block on the semaphore in order. */
+    rt_sleep(1);
+
+    /* Reorder the wait list so that the waiters are woken in order of their
+     * index, regardless of the order they blocked in. */
+    struct rt_task *const tasks[] = {&waiters[0], &waiters[2]};
+    const unsigned priorities[] = {3, 1};
+    rt_task_set_priorities(tasks, priorities, 2);
+
+    for (size_t i = 0; i < NUM_WAITERS; ++i)
+    {
+        rt_sem_post(&sem);
+        rt_sleep(1);
+    }
+    rt_logf("wake order: %u %u %u\n", (unsigned)wake_order[0],
+            (unsigned)wake_order[1], (unsigned)wake_order[2]);
+    if ((num_woken != NUM_WAITERS) || (wake_order[0] != 0) ||
+        (wake_order[1] != 1) || (wake_order[2] != 2))
+    {
+        failed = true;
+    }
+
+    /* Raising a ready task above the manager should switch to it before
+     * rt_task_set_priority returns. */
+    rt_sem_post(&low_sem);
+    if (low_ran)
+    {
+        failed = true;
+    }
+    rt_task_set_priority(&low_task, 5);
+    if (!low_ran)
+    {
+        failed = true;
+    }
+
+    /* Lowering the manager below a ready task should also switch. */
+    low_ran = false;
+    rt_task_set_priority(&low_task, 1);
+    rt_sem_post(&low_sem);
+    rt_task_set_priority(rt_task_self(), 0);
+    if (!low_ran)
+    {
+        failed = true;
+    }
+
+    rt_stop();
+}
+
+int main(void)
+{
+    for (uintptr_t i = 0; i < NUM_WAITERS; ++i)
+    {
+        rt_task_init_arg(&waiters[i], waiter, i, "waiter", 2, waiter_stacks[i],
+                         RT_STACK_MIN);
+    }
+    rt_task_init(&low_task, low, "low", 1, low_stack, sizeof low_stack);
+    RT_TASK(manager, RT_STACK_MIN, 4);
+    rt_start();
+
+    if (failed)
+    {
+        return 1;
+    }
+}
@@ -0,0 +1,159 @@
+#include <muntos/atomic.h>
+#include <muntos/container.h>
+#include <muntos/muntos.h>
+#include <muntos/rcu.h>
+#include <muntos/sleep.h>
+#include <muntos/task.h>
+
+#include <stdint.h>
+
+/*
+ * Readers look up routes in a table while a writer replaces it with new
+ * versions, freeing old versions either directly after a grace period or
+ * through the reclaimer. A reader fails if it sees a version that has been
+ * freed or that is inconsistent.
+ */
+
+#define NUM_READERS 3
+#define NUM_ROUTES 16
+#define NUM_TABLES 4
+#define NUM_UPDATES 100
+
+struct table
+{
+    struct rt_rcu_head head;
+    volatile bool in_use;
+    volatile uint32_t version;
+    volatile uint32_t routes[NUM_ROUTES];
+};
+
+static struct table tables[NUM_TABLES];
+
+static struct table *_Atomic current = NULL;
+
+static RT_RCU(rcu);
+
+static volatile bool failed = false;
+
+static void table_free(struct table *t)
+{
+    /* Clobber the table so that a reader still using it would notice. */
+    for (size_t i = 0; i < NUM_ROUTES; ++i)
+    {
+        t->routes[i] = 0;
+    }
+    t->version = 0;
+    t->in_use = false;
+}
+
+static void table_free_cb(struct rt_rcu_head *head)
+{
+    table_free(rt_container_of(head, struct table, head));
+}
+
+static struct table *table_alloc(void)
+{
+    for (;;)
+    {
+        for (size_t i = 0; i < NUM_TABLES; ++i)
+        {
+            if (!tables[i].in_use)
+            {
+                tables[i].in_use = true;
+                return &tables[i];
+            }
+        }
+        /* Wait for the reclaimer to free a table. */
+        rt_sleep(1);
+    }
+}
+
+static void reader(void)
+{
+    rt_task_drop_privilege();
+    for (;;)
+    {
+        rt_rcu_read_lock();
+        const struct table *const t =
+            rt_atomic_load_explicit(&current, memory_order_acquire);
+        const uint32_t version = t->version;
+        if (!t->in_use || (version == 0))
+        {
+            failed = true;
+        }
+        for (size_t i = 0; i < NUM_ROUTES; ++i)
+        {
+            if (t->routes[i] != version + i)
+            {
+                failed = true;
+            }
+        }
+        rt_rcu_read_unlock();
+    }
+}
+
+static volatile bool done = false;
+
+static void writer(void)
+{
+    rt_task_drop_privilege();
+    for (uint32_t version = 2; version <= NUM_UPDATES; ++version)
+    {
+        struct table *const t = table_alloc();
+        t->version = version;
+        for (size_t i = 0; i < NUM_ROUTES; ++i)
+        {
+            t->routes[i] = version + (uint32_t)i;
+        }
+        struct table *const old =
+            rt_atomic_exchange_explicit(&current, t, memory_order_acq_rel);
+        if ((version % 2) == 0)
+        {
+            rt_rcu_synchronize();
+            table_free(old);
+        }
+        else
+        {
+            rt_rcu_call(&rcu, &old->head, table_free_cb);
+        }
+        rt_sleep(1);
+    }
+    done = true;
+}
+
+static void timeout(void)
+{
+    rt_task_drop_privilege();
+    rt_sleep(1000);
+    rt_stop();
+}
+
+int main(void)
+{
+    struct table *const t = &tables[0];
+    t->in_use = true;
+    t->version = 1;
+    for (size_t i = 0; i < NUM_ROUTES; ++i)
+    {
+        t->routes[i] = 1 + (uint32_t)i;
+    }
+    rt_atomic_store_explicit(&current, t, memory_order_relaxed);
+
+    RT_STACKS(reader_stacks, RT_STACK_MIN, NUM_READERS);
+    static struct rt_task reader_tasks[NUM_READERS];
+    for (int i = 0; i < NUM_READERS; ++i)
+    {
+        rt_task_init(&reader_tasks[i], reader, "reader", 1, reader_stacks[i],
+                     RT_STACK_MIN);
+    }
+
+    RT_TASK(writer, RT_STACK_MIN, 1);
+    RT_TASK_ARG(rt_rcu_reclaimer, (uintptr_t)&rcu, RT_STACK_MIN, 1);
+    RT_TASK(timeout, RT_STACK_MIN, 2);
+    rt_start();
+
+    if (failed || !done)
+    {
+        return 1;
+    }
+}
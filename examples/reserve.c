@@ -0,0 +1,109 @@
+#include <muntos/log.h>
+#include <muntos/muntos.h>
+#include <muntos/queue.h>
+#include <muntos/sleep.h>
+#include <muntos/task.h>
+
+#include <stdint.h>
+
+struct frame
+{
+    uint32_t seq;
+    uint32_t words[31];
+};
+
+RT_QUEUE_STATIC(queue, struct frame, 8);
+
+static void fill(struct frame *frame, uint32_t seq)
+{
+    frame->seq = seq;
+    for (uint32_t i = 0; i < 31; ++i)
+    {
+        frame->words[i] = seq + i;
+    }
+}
+
+static bool valid(const struct frame *frame)
+{
+    for (uint32_t i = 0; i < 31; ++i)
+    {
+        if (frame->words[i] != frame->seq + i)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void producer(void)
+{
+    rt_task_drop_privilege();
+    for (uint32_t seq = 0;; ++seq)
+    {
+        /* Alternate between zero-copy and copying pushes. */
+        if ((seq % 2) == 0)
+        {
+            struct frame *const frame = rt_queue_reserve(&queue);
+            fill(frame, seq);
+            rt_queue_commit(&queue, frame);
+        }
+        else
+        {
+            struct frame frame;
+            fill(&frame, seq);
+            rt_queue_push(&queue, &frame);
+        }
+    }
+}
+
+static volatile bool failed = false;
+static volatile uint32_t num_consumed = 0;
+
+static void consumer(void)
+{
+    rt_task_drop_privilege();
+    for (uint32_t seq = 0;; ++seq)
+    {
+        /* Alternate between zero-copy and copying pops. */
+        if ((seq % 3) == 0)
+        {
+            struct frame frame;
+            rt_queue_pop(&queue, &frame);
+            if ((frame.seq != seq) || !valid(&frame))
+            {
+                failed = true;
+            }
+        }
+        else
+        {
+            struct frame *const frame = rt_queue_acquire(&queue);
+            if ((frame->seq != seq) || !valid(frame))
+            {
+                failed = true;
+            }
+            rt_queue_release(&queue, frame);
+        }
+        num_consumed = seq + 1;
+    }
+}
+
+static void timeout(void)
+{
+    rt_sleep(1000);
+    rt_stop();
+}
+
+int main(void)
+{
+    RT_TASK(producer, RT_STACK_MIN, 1);
+    RT_TASK(consumer, RT_STACK_MIN, 1);
+    RT_TASK(timeout, RT_STACK_MIN, 2);
+    rt_start();
+
+    rt_logf("consumed %u frames\n", (unsigned)num_consumed);
+
+    if (failed || (num_consumed == 0))
+    {
+        return 1;
+    }
+}
@@ -0,0 +1,143 @@
+#include <muntos/log.h>
+#include <muntos/muntos.h>
+#include <muntos/sched.h>
+#include <muntos/sem.h>
+#include <muntos/task.h>
+
+#include <stdint.h>
+
+/*
+ * A producer posts to several higher priority consumers in a burst. Without
+ * the scheduler lock, each post switches to a consumer and back. With it, the
+ * whole burst is posted before any consumer runs, and the consumers run as
+ * soon as it is unlocked.
+ */
+
+#define NUM_CONSUMERS 8
+#define NUM_ROUNDS 100
+
+static struct rt_sem sems[NUM_CONSUMERS];
+static RT_SEM(done, 0);
+
+static volatile bool in_burst = false;
+static volatile unsigned num_preempted = 0;
+
+static void consumer(uintptr_t arg)
+{
+    struct rt_sem *const sem = &sems[arg];
+    for (;;)
+    {
+        rt_sem_wait(sem);
+        if (in_burst)
+        {
+            ++num_preempted;
+        }
+        rt_sem_post(&done);
+    }
+}
+
+static void burst(bool lock)
+{
+    if (lock)
+    {
+        /* Nested locks only unlock the scheduler on the outermost unlock. */
+        rt_sched_lock();
+        rt_sched_lock();
+    }
+    in_burst = true;
+    for (size_t i = 0; i < NUM_CONSUMERS; ++i)
+    {
+        rt_sem_post(&sems[i]);
+    }
+    if (lock)
+    {
+        rt_sched_unlock();
+    }
+    in_burst = false;
+    if (lock)
+    {
+        rt_sched_unlock();
+    }
+    for (size_t i = 0; i < NUM_CONSUMERS; ++i)
+    {
+        rt_sem_wait(&done);
+    }
+}
+
+static volatile bool failed = false;
+
+/*
+ * Post to a consumer with the scheduler locked, and then make a system call
+ * that runs the system call handler while still locked. The unlock must
+ * switch to the consumer even though no system calls are left pending.
+ */
+static void post_and_syscall(bool set_priority)
+{
+    rt_sched_lock();
+    rt_sem_post(&sems[0]);
+    if (set_priority)
+    {
+        rt_task_set_priority(rt_task_self(), 1);
+    }
+    else
+    {
+        rt_task_yield();
+    }
+    if (rt_sem_trywait(&done))
+    {
+        failed = true;
+    }
+    rt_sched_unlock();
+    if (!rt_sem_trywait(&done))
+    {
+        failed = true;
+    }
+}
+
+static void producer(void)
+{
+    for (int i = 0; i < NUM_ROUNDS; ++i)
+    {
+        burst(false);
+    }
+    const unsigned unlocked_preempted = num_preempted;
+    num_preempted = 0;
+
+    for (int i = 0; i < NUM_ROUNDS; ++i)
+    {
+        burst(true);
+    }
+
+    for (int i = 0; i < NUM_ROUNDS; ++i)
+    {
+        post_and_syscall((i % 2) == 0);
+    }
+
+    rt_logf("preempted %u times without the lock, %u with it\n",
+            unlocked_preempted, num_preempted);
+    if ((unlocked_preempted == 0) || (num_preempted != 0))
+    {
+        failed = true;
+    }
+    rt_stop();
+}
+
+RT_STACKS(consumer_stacks, RT_STACK_MIN, NUM_CONSUMERS);
+static struct rt_task consumers[NUM_CONSUMERS];
+
+int main(void)
+{
+    for (uintptr_t i = 0; i < NUM_CONSUMERS; ++i)
+    {
+        rt_sem_init(&sems[i], 0);
+        rt_task_init_arg(&consumers[i], consumer, i, "consumer", 2,
+                         consumer_stacks[i], RT_STACK_MIN);
+    }
+    RT_TASK(producer, RT_STACK_MIN, 1);
+    rt_start();
+
+    if (failed)
+    {
+        return 1;
+    }
+}
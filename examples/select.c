@@ -0,0 +1,139 @@
+#include <muntos/log.h>
+#include <muntos/muntos.h>
+#include <muntos/notify.h>
+#include <muntos/queue.h>
+#include <muntos/select.h>
+#include <muntos/sem.h>
+#include <muntos/sleep.h>
+#include <muntos/task.h>
+
+#include <stdint.h>
+
+#define NUM_QUEUES 3
+#define NUM_ITEMS 1000
+
+RT_QUEUE_STATIC(queue0, uint32_t, 4);
+RT_QUEUE_STATIC(queue1, uint32_t, 4);
+RT_QUEUE_STATIC(queue2, uint32_t, 4);
+static struct rt_queue *const queues[NUM_QUEUES] = {&queue0, &queue1, &queue2};
+
+static RT_SEM(sem, 0);
+static RT_NOTIFY(note, 0);
+
+RT_SELECT_STATIC(set, NUM_QUEUES + 2);
+
+static void pusher(uintptr_t i)
+{
+    rt_task_drop_privilege();
+    for (uint32_t seq = 0; seq < NUM_ITEMS; ++seq)
+    {
+        rt_queue_push(queues[i], &seq);
+    }
+}
+
+static void poster(void)
+{
+    rt_task_drop_privilege();
+    for (uint32_t i = 0; i < NUM_ITEMS; ++i)
+    {
+        rt_sem_post(&sem);
+        rt_notify_or(&note, UINT32_C(1) << (i % 32));
+        if ((i % 64) == 0)
+        {
+            rt_sleep(1);
+        }
+    }
+}
+
+static volatile bool failed = false;
+static volatile bool done = false;
+
+static void gateway(void)
+{
+    rt_task_drop_privilege();
+    uint32_t next[NUM_QUEUES] = {0};
+    uint32_t num_posts = 0;
+    uint32_t bits = 0;
+    for (;;)
+    {
+        void *const object = rt_select_wait(&set);
+        if (object == &sem)
+        {
+            if (!rt_sem_trywait(&sem))
+            {
+                failed = true;
+            }
+            ++num_posts;
+        }
+        else if (object == &note)
+        {
+            uint32_t value;
+            if (!rt_notify_trywait_clear(&note, UINT32_MAX, &value))
+            {
+                failed = true;
+            }
+            bits |= value;
+        }
+        else
+        {
+            for (uintptr_t i = 0; i < NUM_QUEUES; ++i)
+            {
+                if (object != queues[i])
+                {
+                    continue;
+                }
+                uint32_t seq;
+                if (!rt_queue_trypop(queues[i], &seq) || (seq != next[i]))
+                {
+                    failed = true;
+                }
+                ++next[i];
+            }
+        }
+
+        bool all_received = (num_posts == NUM_ITEMS) && (bits == UINT32_MAX);
+        for (uintptr_t i = 0; i < NUM_QUEUES; ++i)
+        {
+            all_received = all_received && (next[i] == NUM_ITEMS);
+        }
+        if (all_received)
+        {
+            /* Nothing should be left once everything has been received. */
+            if (rt_select_timedwait(&set, 10) != NULL)
+            {
+                failed = true;
+            }
+            done = true;
+            rt_stop();
+        }
+    }
+}
+
+static void timeout(void)
+{
+    rt_sleep(5000);
+    rt_stop();
+}
+
+int main(void)
+{
+    for (uintptr_t i = 0; i < NUM_QUEUES; ++i)
+    {
+        rt_select_add_queue(&set, queues[i]);
+    }
+    rt_select_add_sem(&set, &sem);
+    rt_select_add_notify(&set, &note);
+
+    RT_TASK_ARG(pusher, 0, RT_STACK_MIN, 1);
+    RT_TASK_ARG(pusher, 1, RT_STACK_MIN, 2);
+    RT_TASK_ARG(pusher, 2, RT_STACK_MIN, 3);
+    RT_TASK(poster, RT_STACK_MIN, 2);
+    RT_TASK(gateway, RT_STACK_MIN, 1);
+    RT_TASK(timeout, RT_STACK_MIN, 4);
+    rt_start();
+
+    if (failed || !done)
+    {
+        return 1;
+    }
+}
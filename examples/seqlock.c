@@ -0,0 +1,82 @@
+#include <muntos/log.h>
+#include <muntos/muntos.h>
+#include <muntos/seqlock.h>
+#include <muntos/sleep.h>
+#include <muntos/task.h>
+
+#define NUM_READERS 3
+#define NUM_WORDS 50
+
+static RT_SEQLOCK(lock);
+static volatile unsigned long state[NUM_WORDS];
+
+static volatile bool mismatch = false;
+
+static void reader(void)
+{
+    rt_task_drop_privilege();
+    for (;;)
+    {
+        unsigned long snapshot[NUM_WORDS];
+        unsigned seq;
+        do
+        {
+            seq = rt_seqlock_read_begin(&lock);
+            for (size_t i = 0; i < NUM_WORDS; ++i)
+            {
+                snapshot[i] = state[i];
+            }
+        } while (rt_seqlock_read_retry(&lock, seq));
+
+        for (size_t i = 1; i < NUM_WORDS; ++i)
+        {
+            if (snapshot[i] != snapshot[0])
+            {
+                mismatch = true;
+            }
+        }
+    }
+}
+
+static void writer(void)
+{
+    rt_task_drop_privilege();
+    for (unsigned long n = 1;; ++n)
+    {
+        rt_seqlock_write_begin(&lock);
+        for (size_t i = 0; i < NUM_WORDS; ++i)
+        {
+            state[i] = n;
+        }
+        rt_seqlock_write_end(&lock);
+        rt_sleep(1);
+    }
+}
+
+static void timeout(void)
+{
+    rt_sleep(1000);
+    rt_stop();
+}
+
+int main(void)
+{
+    RT_STACKS(reader_stacks, RT_STACK_MIN, NUM_READERS);
+    static struct rt_task reader_tasks[NUM_READERS];
+    for (int i = 0; i < NUM_READERS; ++i)
+    {
+        rt_task_init(&reader_tasks[i], reader, "reader", 1, reader_stacks[i],
+                     RT_STACK_MIN);
+    }
+
+    /* The writer runs at the readers' priority, so it is preempted by them
+     * in the middle of writes, and they must retry. */
+    RT_TASK(writer, RT_STACK_MIN, 1);
+    RT_TASK(timeout, RT_STACK_MIN, 2);
+    rt_start();
+
+    if (mismatch)
+    {
+        return 1;
+    }
+}
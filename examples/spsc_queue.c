@@ -0,0 +1,90 @@
+#include <muntos/log.h>
+#include <muntos/muntos.h>
+#include <muntos/sleep.h>
+#include <muntos/spsc_queue.h>
+#include <muntos/task.h>
+
+#include <stdint.h>
+
+RT_SPSC_QUEUE_STATIC(queue, uint32_t, 8);
+
+static void pusher(void)
+{
+    rt_task_drop_privilege();
+    for (uint32_t i = 0;; ++i)
+    {
+        switch (i % 3)
+        {
+        case 0:
+            rt_spsc_queue_push(&queue, &i);
+            break;
+        case 1:
+            while (!rt_spsc_queue_trypush(&queue, &i))
+            {
+                rt_sleep(1);
+            }
+            break;
+        default:
+            while (!rt_spsc_queue_timedpush(&queue, &i, 1))
+            {
+            }
+            break;
+        }
+    }
+}
+
+static volatile bool out_of_order = false;
+static volatile uint32_t num_popped = 0;
+
+static void popper(void)
+{
+    rt_task_drop_privilege();
+    for (uint32_t i = 0;; ++i)
+    {
+        uint32_t x, y;
+        rt_spsc_queue_peek(&queue, &y);
+        switch (i % 3)
+        {
+        case 0:
+            rt_spsc_queue_pop(&queue, &x);
+            break;
+        case 1:
+            while (!rt_spsc_queue_trypop(&queue, &x))
+            {
+                rt_sleep(1);
+            }
+            break;
+        default:
+            while (!rt_spsc_queue_timedpop(&queue, &x, 1))
+            {
+            }
+            break;
+        }
+        if ((x != i) || (y != i))
+        {
+            out_of_order = true;
+        }
+        num_popped = i + 1;
+    }
+}
+
+static void timeout(void)
+{
+    rt_sleep(1000);
+    rt_stop();
+}
+
+int main(void)
+{
+    RT_TASK(pusher, RT_STACK_MIN, 1);
+    RT_TASK(popper, RT_STACK_MIN, 1);
+    RT_TASK(timeout, RT_STACK_MIN, 2);
+    rt_start();
+
+    rt_logf("popped %u elements\n", (unsigned)num_popped);
+
+    if (out_of_order || (num_popped == 0))
+    {
+        return 1;
+    }
+}
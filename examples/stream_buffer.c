@@ -0,0 +1,134 @@
+#include <muntos/log.h>
+#include <muntos/muntos.h>
+#include <muntos/sleep.h>
+#include <muntos/stream_buffer.h>
+#include <muntos/task.h>
+
+#include <stdint.h>
+
+RT_STREAM_BUFFER_STATIC(stream, 64);
+
+static void writer(void)
+{
+    rt_task_drop_privilege();
+    unsigned char next = 0;
+    for (uint32_t i = 0;; ++i)
+    {
+        /* Write bursts of varying sizes, some larger than the buffer. */
+        unsigned char burst[80];
+        size_t len = 1 + ((i * 37) % sizeof burst);
+        for (size_t j = 0; j < len; ++j)
+        {
+            burst[j] = (unsigned char)(next + j);
+        }
+        switch (i % 4)
+        {
+        case 0:
+            rt_stream_buffer_write(&stream, burst, len);
+            break;
+        case 1:
+            /* A partial write only writes what fits, so send the rest of the
+             * burst as a later one. */
+            len = rt_stream_buffer_trywrite(&stream, burst, len);
+            if (len == 0)
+            {
+                rt_sleep(1);
+            }
+            break;
+        case 2:
+            len = rt_stream_buffer_timedwrite(&stream, burst, len, 1);
+            break;
+        default:
+        {
+            void *region;
+            const size_t n = rt_stream_buffer_write_region(&stream, &region);
+            if (len > n)
+            {
+                len = n;
+            }
+            for (size_t j = 0; j < len; ++j)
+            {
+                ((unsigned char *)region)[j] = (unsigned char)(next + j);
+            }
+            rt_stream_buffer_commit(&stream, len);
+            if (len == 0)
+            {
+                rt_sleep(1);
+            }
+            break;
+        }
+        }
+        next = (unsigned char)(next + len);
+    }
+}
+
+static volatile bool failed = false;
+static volatile uint32_t num_read = 0;
+
+static void reader(void)
+{
+    rt_task_drop_privilege();
+    rt_stream_buffer_set_trigger(&stream, 16);
+    unsigned char next = 0;
+    for (uint32_t i = 0;; ++i)
+    {
+        unsigned char buf[24];
+        const unsigned char *data = buf;
+        size_t len;
+        switch (i % 3)
+        {
+        case 0:
+            len = rt_stream_buffer_read(&stream, buf, sizeof buf);
+            /* A blocking read only returns once the trigger level is met. */
+            if (len < 16)
+            {
+                failed = true;
+            }
+            break;
+        case 1:
+            len = rt_stream_buffer_timedread(&stream, buf, sizeof buf, 1);
+            break;
+        default:
+        {
+            const void *region;
+            len = rt_stream_buffer_read_region(&stream, &region);
+            data = region;
+            break;
+        }
+        }
+        for (size_t j = 0; j < len; ++j)
+        {
+            if (data[j] != next)
+            {
+                failed = true;
+            }
+            ++next;
+        }
+        if (data != buf)
+        {
+            rt_stream_buffer_consume(&stream, len);
+        }
+        num_read += (uint32_t)len;
+    }
+}
+
+static void timeout(void)
+{
+    rt_sleep(1000);
+    rt_stop();
+}
+
+int main(void)
+{
+    RT_TASK(writer, RT_STACK_MIN, 1);
+    RT_TASK(reader, RT_STACK_MIN, 1);
+    RT_TASK(timeout, RT_STACK_MIN, 2);
+    rt_start();
+
+    rt_logf("read %u bytes\n", (unsigned)num_read);
+
+    if (failed || (num_read == 0))
+    {
+        return 1;
+    }
+}
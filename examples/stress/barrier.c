@@ -0,0 +1,132 @@
+#include <muntos/atomic.h>
+#include <muntos/barrier.h>
+#include <muntos/cond.h>
+#include <muntos/log.h>
+#include <muntos/muntos.h>
+#include <muntos/mutex.h>
+#include <muntos/sem.h>
+#include <muntos/task.h>
+#include <muntos/tick.h>
+
+#include <stdint.h>
+
+/*
+ * Run several tasks through a number of barrier phases, first with rt_barrier
+ * and then with a barrier composed of a semaphore, a mutex, and a condition
+ * variable, as rt_barrier used to be, and report the phases per second of
+ * each. TICKS_PER_SECOND should match the port's tick rate.
+ */
+
+#define NTASKS 4
+#define PHASES 2000
+#define TICKS_PER_SECOND 1000
+
+struct composite_barrier
+{
+    struct rt_sem sem;
+    struct rt_mutex mutex;
+    struct rt_cond cond;
+    int tasks, count;
+};
+
+static struct composite_barrier composite = {
+    .sem = RT_SEM_INIT(composite.sem, NTASKS),
+    .mutex = RT_MUTEX_INIT(composite.mutex),
+    .cond = RT_COND_INIT(composite.cond),
+    .tasks = 0,
+    .count = NTASKS,
+};
+
+static void composite_wait(struct composite_barrier *barrier)
+{
+    rt_sem_wait(&barrier->sem);
+    rt_mutex_lock(&barrier->mutex);
+    ++barrier->tasks;
+    if (barrier->tasks == barrier->count)
+    {
+        rt_cond_broadcast(&barrier->cond);
+    }
+    else
+    {
+        rt_cond_wait(&barrier->cond, &barrier->mutex);
+    }
+    --barrier->tasks;
+    if (barrier->tasks == 0)
+    {
+        rt_sem_post_n(&barrier->sem, barrier->count);
+    }
+    rt_mutex_unlock(&barrier->mutex);
+}
+
+static RT_BARRIER(native, NTASKS);
+
+static RT_SEM(done_sem, 0);
+
+static rt_atomic_uint arrivals = 0;
+static volatile bool invalid = false;
+
+static void participant(uintptr_t use_native)
+{
+    for (unsigned i = 0; i < PHASES; ++i)
+    {
+        rt_atomic_fetch_add_explicit(&arrivals, 1, memory_order_relaxed);
+        if (use_native)
+        {
+            rt_barrier_wait(&native);
+        }
+        else
+        {
+            composite_wait(&composite);
+        }
+        /* Every task must have arrived for this phase before any leaves. */
+        if (rt_atomic_load_explicit(&arrivals, memory_order_relaxed) <
+            (i + 1) * NTASKS)
+        {
+            invalid = true;
+        }
+    }
+    rt_sem_post(&done_sem);
+}
+
+RT_STACKS(participant_stacks, RT_STACK_MIN, 2 * NTASKS);
+static struct rt_task participants[2][NTASKS];
+
+static void bench(void)
+{
+    static const char *const names[2] = {"composite", "native"};
+    for (uintptr_t use_native = 0; use_native < 2; ++use_native)
+    {
+        rt_atomic_store_explicit(&arrivals, 0, memory_order_relaxed);
+        const unsigned long start_tick = rt_tick();
+        for (size_t t = 0; t < NTASKS; ++t)
+        {
+            rt_task_init_arg(&participants[use_native][t], participant,
+                             use_native, names[use_native], 1,
+                             participant_stacks[(use_native * NTASKS) + t],
+                             RT_STACK_MIN);
+        }
+        for (size_t t = 0; t < NTASKS; ++t)
+        {
+            rt_sem_wait(&done_sem);
+        }
+        unsigned long ticks = rt_tick() - start_tick;
+        if (ticks == 0)
+        {
+            ticks = 1;
+        }
+        rt_logf("%s: %lu phases per second\n", names[use_native],
+                (PHASES * TICKS_PER_SECOND) / ticks);
+    }
+    rt_stop();
+}
+
+int main(void)
+{
+    RT_TASK(bench, RT_STACK_MIN, 2);
+    rt_start();
+
+    if (invalid)
+    {
+        return 1;
+    }
+}
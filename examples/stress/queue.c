@@ -0,0 +1,103 @@
+#include <muntos/cycle.h>
+#include <muntos/log.h>
+#include <muntos/muntos.h>
+#include <muntos/queue.h>
+#include <muntos/sem.h>
+#include <muntos/task.h>
+
+#include <stdint.h>
+
+/*
+ * Push and pop through each queue layout with several pushers and poppers of
+ * the same priority, so that queue operations are preempted by each other,
+ * and report the cycles taken per element.
+ */
+
+#define NPUSHERS 3
+#define NPOPPERS 3
+#define ITERATIONS 2000
+#define NLAYOUTS 3
+
+RT_QUEUE_STATIC(queue_default, uint32_t, 10);
+RT_QUEUE_STATIC(queue_pow2, uint32_t, 16);
+RT_QUEUE_STATIC_INTERLEAVED(queue_interleaved, uint32_t, 16);
+
+static struct rt_queue *const queues[NLAYOUTS] = {
+    &queue_default,
+    &queue_pow2,
+    &queue_interleaved,
+};
+
+static const char *const layout_names[NLAYOUTS] = {
+    "default",
+    "power-of-two",
+    "interleaved",
+};
+
+static RT_SEM(done_sem, 0);
+
+static volatile bool invalid = false;
+
+static void pusher(uintptr_t arg)
+{
+    struct rt_queue *const queue = (struct rt_queue *)arg;
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+    {
+        rt_queue_push(queue, &i);
+    }
+    rt_sem_post(&done_sem);
+}
+
+static void popper(uintptr_t arg)
+{
+    struct rt_queue *const queue = (struct rt_queue *)arg;
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+    {
+        uint32_t x;
+        rt_queue_pop(queue, &x);
+        if (x >= ITERATIONS)
+        {
+            invalid = true;
+        }
+    }
+    rt_sem_post(&done_sem);
+}
+
+#define NWORKERS (NPUSHERS + NPOPPERS)
+
+RT_STACKS(worker_stacks, RT_STACK_MIN, NLAYOUTS *NWORKERS);
+static struct rt_task workers[NLAYOUTS][NWORKERS];
+
+static void bench(void)
+{
+    for (size_t l = 0; l < NLAYOUTS; ++l)
+    {
+        const uintptr_t arg = (uintptr_t)queues[l];
+        const uint32_t start_cycle = rt_cycle();
+        for (size_t w = 0; w < NWORKERS; ++w)
+        {
+            rt_task_init_arg(&workers[l][w], (w < NPUSHERS) ? pusher : popper,
+                             arg, layout_names[l], 1,
+                             worker_stacks[(l * NWORKERS) + w], RT_STACK_MIN);
+        }
+        for (size_t w = 0; w < NWORKERS; ++w)
+        {
+            rt_sem_wait(&done_sem);
+        }
+        const uint32_t cycles = rt_cycle() - start_cycle;
+        rt_logf("%s: %u cycles per element\n", layout_names[l],
+                (unsigned)(cycles / (NPUSHERS * ITERATIONS)));
+    }
+    rt_stop();
+}
+
+int main(void)
+{
+    RT_TASK(bench, RT_STACK_MIN, 2);
+    rt_start();
+
+    if (invalid)
+    {
+        return 1;
+    }
+}
@@ -0,0 +1,155 @@
+#include <muntos/atomic.h>
+#include <muntos/log.h>
+#include <muntos/muntos.h>
+#include <muntos/rwlock.h>
+#include <muntos/sem.h>
+#include <muntos/seqlock.h>
+#include <muntos/sleep.h>
+#include <muntos/task.h>
+#include <muntos/tick.h>
+
+#include <stdint.h>
+
+/*
+ * Read a 200-byte structure from several tasks while a higher priority task
+ * updates it every tick, first under rt_rwlock and then under rt_seqlock, and
+ * report the reads per second of each. TICKS_PER_SECOND should match the
+ * port's tick rate.
+ */
+
+#define NREADERS 3
+#define READS 200000
+#define NWORDS 50
+#define TICKS_PER_SECOND 1000
+
+static RT_RWLOCK(rwlock);
+static RT_SEQLOCK(seqlock);
+
+static volatile uint32_t state[NWORDS];
+
+static RT_SEM(done_sem, 0);
+
+static rt_atomic_bool reading = false;
+static volatile bool invalid = false;
+
+static void read_state(bool use_seqlock, uint32_t *snapshot)
+{
+    if (use_seqlock)
+    {
+        unsigned seq;
+        do
+        {
+            seq = rt_seqlock_read_begin(&seqlock);
+            for (size_t i = 0; i < NWORDS; ++i)
+            {
+                snapshot[i] = state[i];
+            }
+        } while (rt_seqlock_read_retry(&seqlock, seq));
+    }
+    else
+    {
+        rt_rwlock_rlock(&rwlock);
+        for (size_t i = 0; i < NWORDS; ++i)
+        {
+            snapshot[i] = state[i];
+        }
+        rt_rwlock_runlock(&rwlock);
+    }
+}
+
+static void reader(uintptr_t use_seqlock)
+{
+    for (unsigned r = 0; r < READS; ++r)
+    {
+        uint32_t snapshot[NWORDS];
+        read_state(use_seqlock != 0, snapshot);
+        for (size_t i = 1; i < NWORDS; ++i)
+        {
+            if (snapshot[i] != snapshot[0])
+            {
+                invalid = true;
+            }
+        }
+    }
+    rt_sem_post(&done_sem);
+}
+
+static void writer(uintptr_t use_seqlock)
+{
+    for (uint32_t n = 1;
+         rt_atomic_load_explicit(&reading, memory_order_relaxed); ++n)
+    {
+        if (use_seqlock)
+        {
+            rt_seqlock_write_begin(&seqlock);
+        }
+        else
+        {
+            rt_rwlock_wlock(&rwlock);
+        }
+        for (size_t i = 0; i < NWORDS; ++i)
+        {
+            state[i] = n;
+        }
+        if (use_seqlock)
+        {
+            rt_seqlock_write_end(&seqlock);
+        }
+        else
+        {
+            rt_rwlock_wunlock(&rwlock);
+        }
+        rt_sleep(1);
+    }
+    rt_sem_post(&done_sem);
+}
+
+RT_STACKS(reader_stacks, RT_STACK_MIN, 2 * NREADERS);
+static struct rt_task readers[2][NREADERS];
+RT_STACKS(writer_stacks, RT_STACK_MIN, 2);
+static struct rt_task writers[2];
+
+static void bench(void)
+{
+    static const char *const names[2] = {"rwlock", "seqlock"};
+    for (uintptr_t use_seqlock = 0; use_seqlock < 2; ++use_seqlock)
+    {
+        rt_atomic_store_explicit(&reading, true, memory_order_relaxed);
+        const unsigned long start_tick = rt_tick();
+        rt_task_init_arg(&writers[use_seqlock], writer, use_seqlock,
+                         names[use_seqlock], 2, writer_stacks[use_seqlock],
+                         RT_STACK_MIN);
+        for (size_t t = 0; t < NREADERS; ++t)
+        {
+            rt_task_init_arg(&readers[use_seqlock][t], reader, use_seqlock,
+                             names[use_seqlock], 1,
+                             reader_stacks[(use_seqlock * NREADERS) + t],
+                             RT_STACK_MIN);
+        }
+        for (size_t t = 0; t < NREADERS; ++t)
+        {
+            rt_sem_wait(&done_sem);
+        }
+        unsigned long ticks = rt_tick() - start_tick;
+        if (ticks == 0)
+        {
+            ticks = 1;
+        }
+        rt_atomic_store_explicit(&reading, false, memory_order_relaxed);
+        rt_sem_wait(&done_sem);
+        rt_logf("%s: %lu reads per second\n", names[use_seqlock],
+                ((unsigned long)NREADERS * READS * TICKS_PER_SECOND) / ticks);
+    }
+    rt_stop();
+}
+
+int main(void)
+{
+    RT_TASK(bench, RT_STACK_MIN, 3);
+    rt_start();
+
+    if (invalid)
+    {
+        return 1;
+    }
+}
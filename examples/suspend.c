@@ -0,0 +1,159 @@
+#include <muntos/log.h>
+#include <muntos/muntos.h>
+#include <muntos/sched.h>
+#include <muntos/sem.h>
+#include <muntos/sleep.h>
+#include <muntos/task.h>
+
+#include <stdint.h>
+
+#define NUM_WORKERS 50
+
+static volatile unsigned counts[NUM_WORKERS];
+
+static void worker(uintptr_t arg)
+{
+    for (;;)
+    {
+        rt_sleep(1);
+        ++counts[arg];
+    }
+}
+
+static RT_SEM(sem, 0);
+static volatile bool waiter_woken = false;
+
+static void waiter(void)
+{
+    rt_sem_wait(&sem);
+    waiter_woken = true;
+}
+
+static volatile bool self_resumed = false;
+
+static void self(void)
+{
+    rt_task_suspend(rt_task_self());
+    self_resumed = true;
+}
+
+static volatile bool locked_ran_on = false;
+static volatile bool locked_resumed = false;
+
+static void locked_self(void)
+{
+    /* A task that suspends itself with the scheduler locked keeps running
+     * until the outermost unlock, even through a system call. */
+    rt_sched_lock();
+    rt_task_suspend(rt_task_self());
+    rt_task_yield();
+    locked_ran_on = true;
+    rt_sched_unlock();
+    locked_resumed = true;
+}
+
+RT_STACKS(worker_stacks, RT_STACK_MIN, NUM_WORKERS);
+static struct rt_task workers[NUM_WORKERS];
+static struct rt_task *worker_ptrs[NUM_WORKERS];
+RT_STACK(waiter_stack, RT_STACK_MIN);
+static struct rt_task waiter_task;
+RT_STACK(self_stack, RT_STACK_MIN);
+static struct rt_task self_task;
+RT_STACK(locked_self_stack, RT_STACK_MIN);
+static struct rt_task locked_self_task;
+
+static volatile bool failed = false;
+
+static void controller(void)
+{
+    rt_sleep(10);
+
+    /* Freeze all of the workers at once. */
+    rt_task_suspend_group(worker_ptrs, NUM_WORKERS);
+    unsigned frozen[NUM_WORKERS];
+    for (size_t i = 0; i < NUM_WORKERS; ++i)
+    {
+        frozen[i] = counts[i];
+    }
+    rt_sleep(10);
+    for (size_t i = 0; i < NUM_WORKERS; ++i)
+    {
+        if (counts[i] != frozen[i])
+        {
+            failed = true;
+        }
+    }
+    rt_task_resume_group(worker_ptrs, NUM_WORKERS);
+    rt_sleep(10);
+    for (size_t i = 0; i < NUM_WORKERS; ++i)
+    {
+        if (counts[i] == frozen[i])
+        {
+            failed = true;
+        }
+    }
+
+    /* A suspended task that is woken stays suspended until it is resumed. */
+    rt_task_suspend(&waiter_task);
+    rt_sem_post(&sem);
+    rt_sleep(5);
+    if (waiter_woken)
+    {
+        failed = true;
+    }
+    rt_task_resume(&waiter_task);
+    rt_sleep(1);
+    if (!waiter_woken)
+    {
+        failed = true;
+    }
+
+    /* A task that suspended itself only continues once resumed. */
+    if (self_resumed)
+    {
+        failed = true;
+    }
+    rt_task_resume(&self_task);
+    rt_sleep(1);
+    if (!self_resumed)
+    {
+        failed = true;
+    }
+
+    /* The sleeps above only return if the scheduler was unlocked when the
+     * task that locked it suspended itself. */
+    if (!locked_ran_on || locked_resumed || rt_sched_is_locked())
+    {
+        failed = true;
+    }
+    rt_task_resume(&locked_self_task);
+    rt_sleep(1);
+    if (!locked_resumed)
+    {
+        failed = true;
+    }
+
+    rt_stop();
+}
+
+int main(void)
+{
+    for (uintptr_t i = 0; i < NUM_WORKERS; ++i)
+    {
+        rt_task_init_arg(&workers[i], worker, i, "worker", 1, worker_stacks[i],
+                         RT_STACK_MIN);
+        worker_ptrs[i] = &workers[i];
+    }
+    rt_task_init(&waiter_task, waiter, "waiter", 2, waiter_stack,
+                 sizeof waiter_stack);
+    rt_task_init(&self_task, self, "self", 2, self_stack, sizeof self_stack);
+    rt_task_init(&locked_self_task, locked_self, "locked_self", 2,
+                 locked_self_stack, sizeof locked_self_stack);
+    RT_TASK(controller, RT_STACK_MIN, 3);
+    rt_start();
+
+    if (failed)
+    {
+        return 1;
+    }
+}
@@ -0,0 +1,83 @@
+#include <muntos/muntos.h>
+#include <muntos/sleep.h>
+#include <muntos/task.h>
+#include <muntos/task_notify.h>
+
+static const int n = 10;
+
+static struct rt_task *volatile waiter_self = NULL;
+
+static void notifier(void)
+{
+    rt_task_drop_privilege();
+    while (waiter_self == NULL)
+    {
+        rt_sleep(1);
+    }
+
+    for (int i = 1; i <= n; ++i)
+    {
+        rt_sleep(5);
+        rt_task_notify_or(waiter_self, 1);
+    }
+
+    /* Notifications made while one is pending are combined. */
+    rt_sleep(5);
+    rt_task_notify_set(waiter_self, 10);
+    rt_task_notify_add(waiter_self, 5);
+    rt_task_notify_increment(waiter_self);
+
+    rt_sleep(15);
+    rt_task_notify(waiter_self);
+}
+
+static volatile bool wait_failed = false;
+
+static void waiter(void)
+{
+    rt_task_drop_privilege();
+    waiter_self = rt_task_self();
+    uint32_t value;
+
+    for (int i = 1; i <= n; ++i)
+    {
+        if (!rt_task_notify_timedwait_clear(1, &value, 10) || (value != 1))
+        {
+            wait_failed = true;
+        }
+    }
+
+    rt_sleep(10);
+    if (!rt_task_notify_trywait(&value) || (value != 16))
+    {
+        wait_failed = true;
+    }
+    if (rt_task_notify_trywait(&value))
+    {
+        wait_failed = true;
+    }
+
+    if (rt_task_notify_timedwait(&value, 5))
+    {
+        wait_failed = true;
+    }
+
+    if (rt_task_notify_wait() != 16)
+    {
+        wait_failed = true;
+    }
+
+    rt_stop();
+}
+
+int main(void)
+{
+    RT_TASK(notifier, RT_STACK_MIN, 1);
+    RT_TASK(waiter, RT_STACK_MIN, 1);
+
+    rt_start();
+    if (wait_failed)
+    {
+        return 1;
+    }
+}
@@ -0,0 +1,65 @@
+#include <muntos/log.h>
+#include <muntos/muntos.h>
+#include <muntos/sleep.h>
+#include <muntos/task.h>
+#include <muntos/timer.h>
+
+#include <stdint.h>
+
+static volatile unsigned counts[4];
+
+static void count(uintptr_t i)
+{
+    ++counts[i];
+}
+
+static RT_TIMER(oneshot, count, 0);
+static RT_TIMER(periodic, count, 1);
+static RT_TIMER(stopped, count, 2);
+static RT_TIMER(watchdog, count, 3);
+
+static void starter(void)
+{
+    rt_task_drop_privilege();
+    rt_timer_start(&oneshot, 10, 0);
+    rt_timer_start(&periodic, 5, 5);
+    rt_timer_start(&stopped, 20, 0);
+    rt_timer_start(&watchdog, 10, 0);
+    rt_sleep(10);
+    rt_timer_stop(&stopped);
+}
+
+static void kicker(void)
+{
+    rt_task_drop_privilege();
+    for (;;)
+    {
+        rt_sleep(5);
+        rt_timer_reset(&watchdog);
+    }
+}
+
+static void timeout(void)
+{
+    rt_task_drop_privilege();
+    rt_sleep(1000);
+    rt_stop();
+}
+
+int main(void)
+{
+    RT_TASK(rt_timer_daemon, RT_STACK_MIN, 3);
+    RT_TASK(starter, RT_STACK_MIN, 2);
+    RT_TASK(kicker, RT_STACK_MIN, 2);
+    RT_TASK(timeout, RT_STACK_MIN, 4);
+    rt_start();
+
+    rt_logf("oneshot %u, periodic %u, stopped %u, watchdog %u\n", counts[0],
+            counts[1], counts[2], counts[3]);
+
+    if ((counts[0] != 1) || (counts[1] < 190) || (counts[1] > 200) ||
+        (counts[2] != 0) || (counts[3] != 0))
+    {
+        return 1;
+    }
+}
@@ -0,0 +1,89 @@
+#include <muntos/container.h>
+#include <muntos/log.h>
+#include <muntos/muntos.h>
+#include <muntos/sleep.h>
+#include <muntos/task.h>
+#include <muntos/workqueue.h>
+
+#include <stdint.h>
+
+struct counter
+{
+    struct rt_work work;
+    volatile unsigned runs;
+};
+
+static void count(struct rt_work *work)
+{
+    struct counter *const counter =
+        rt_container_of(work, struct counter, work);
+    ++counter->runs;
+}
+
+#define NUM_COUNTERS 4
+#define NUM_ROUNDS 100
+
+static struct counter counters[NUM_COUNTERS] = {
+    {.work = RT_WORK_INIT(counters[0].work, count), .runs = 0},
+    {.work = RT_WORK_INIT(counters[1].work, count), .runs = 0},
+    {.work = RT_WORK_INIT(counters[2].work, count), .runs = 0},
+    {.work = RT_WORK_INIT(counters[3].work, count), .runs = 0},
+};
+
+static RT_WORKQUEUE(wq);
+
+static volatile bool failed = false;
+static volatile bool done = false;
+static unsigned submitted = 0;
+
+static void submitter(void)
+{
+    rt_task_drop_privilege();
+    for (int round = 0; round < NUM_ROUNDS; ++round)
+    {
+        for (int i = 0; i < NUM_COUNTERS; ++i)
+        {
+            if (rt_workqueue_submit(&wq, &counters[i].work))
+            {
+                ++submitted;
+            }
+        }
+        /* The workers run at lower priority than this task, so every counter
+         * is still pending and another submission should coalesce. */
+        if (rt_workqueue_submit(&wq, &counters[0].work))
+        {
+            failed = true;
+        }
+        rt_sleep(1);
+    }
+    done = true;
+}
+
+static void timeout(void)
+{
+    rt_task_drop_privilege();
+    rt_sleep(1000);
+    rt_stop();
+}
+
+int main(void)
+{
+    RT_TASK_ARG(rt_workqueue_worker, (uintptr_t)&wq, RT_STACK_MIN, 1);
+    RT_TASK_ARG(rt_workqueue_worker, (uintptr_t)&wq, RT_STACK_MIN, 2);
+    RT_TASK(submitter, RT_STACK_MIN, 3);
+    RT_TASK(timeout, RT_STACK_MIN, 4);
+    rt_start();
+
+    unsigned runs = 0;
+    for (int i = 0; i < NUM_COUNTERS; ++i)
+    {
+        runs += counters[i].runs;
+    }
+    rt_logf("submitted %u, ran %u\n", submitted, runs);
+
+    if (failed || !done || (submitted != NUM_COUNTERS * NUM_ROUNDS) ||
+        (runs != submitted))
+    {
+        return 1;
+    }
+}
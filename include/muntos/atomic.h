@@ -38,6 +38,9 @@ typedef _Atomic uint32_t rt_atomic_uint32_t;
 #define rt_atomic_compare_exchange_strong_explicit                             \
     atomic_compare_exchange_strong_explicit
 
+#define rt_atomic_thread_fence atomic_thread_fence
+#define rt_atomic_signal_fence atomic_signal_fence
+
 /*
  * Work around a bug in gcc where atomic_flag operations silently don't
  * generate atomic code on armv6-m rather than failing to link. The equivalent
@@ -1,8 +1,16 @@
 #ifndef RT_BARRIER_H
 #define RT_BARRIER_H
 
-#include <muntos/cond.h>
-#include <muntos/mutex.h>
+/*
+ * A barrier counts arrivals with one atomic word, and each arrival other than
+ * the last blocks on the semaphore for the current generation. The last
+ * arrival flips the generation and releases all of the waiters with a single
+ * post, so each task makes at most one system call per phase. Tasks that
+ * race ahead into the next phase wait on the other generation's semaphore, so
+ * they can't take posts meant for the previous phase.
+ */
+
+#include <muntos/atomic.h>
 #include <muntos/sem.h>
 
 #include <stdbool.h>
@@ -14,23 +22,28 @@ void rt_barrier_init(struct rt_barrier *barrier, int count);
 /*
  * Blocks until count threads have called it, at which point it returns
  * true to one of those threads and false to the others, and resets to its
- * initial state, waiting for another count threads.
+ * initial state, waiting for another count threads. At most count threads
+ * may wait on the barrier at a time.
  */
 bool rt_barrier_wait(struct rt_barrier *barrier);
 
 struct rt_barrier
 {
-    struct rt_sem sem;
-    struct rt_mutex mutex;
-    struct rt_cond cond;
-    int tasks, count;
+    /* The number of arrivals in the current phase, and the generation in the
+     * top bit. */
+    rt_atomic_uint state;
+    unsigned count;
+    struct rt_sem sems[2];
 };
 
 #define RT_BARRIER_INIT(name, count_)                                          \
     {                                                                          \
-        .sem = RT_SEM_INIT(name.sem, count_),                                  \
-        .mutex = RT_MUTEX_INIT(name.mutex), .cond = RT_COND_INIT(name.cond),   \
-        .tasks = 0, .count = (count_),                                         \
+        .state = 0, .count = (count_),                                         \
+        .sems =                                                                \
+            {                                                                  \
+                RT_SEM_INIT(name.sems[0], 0),                                  \
+                RT_SEM_INIT(name.sems[1], 0),                                  \
+            },                                                                 \
     }
 
 #define RT_BARRIER(name, count)                                                \
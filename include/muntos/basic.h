@@ -0,0 +1,87 @@
+#ifndef RT_BASIC_H
+#define RT_BASIC_H
+
+/*
+ * Basic tasks are functions that run to completion each time they are
+ * activated, and never wait. A group of basic tasks is run by one host task,
+ * highest priority first, so members of a group never preempt each other and
+ * all of them share the host task's stack. Activations are counted, so a
+ * basic task that is activated several times before it runs will run that many
+ * times. Basic tasks can be activated from tasks or interrupts.
+ *
+ * The host task should be created with a preemption threshold at least as high
+ * as the priority of any task that doesn't need to interleave with the group,
+ * e.g., RT_TASK_ARG_THRESHOLD(rt_basic_group_run, (uintptr_t)&group, stack,
+ * priority, threshold). The host is dispatched at its priority, and then runs
+ * pending basic tasks until there are none left without being preempted by
+ * tasks at or below its threshold.
+ */
+
+#include <muntos/atomic.h>
+#include <muntos/sem.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct rt_basic_task;
+struct rt_basic_group;
+
+/*
+ * Activate a basic task in group.
+ */
+void rt_basic_task_activate(struct rt_basic_group *group,
+                            struct rt_basic_task *task);
+
+/*
+ * The task function of a group's host. arg is a pointer to the struct
+ * rt_basic_group.
+ */
+void rt_basic_group_run(uintptr_t arg);
+
+/*
+ * The worst-case stack size of a group's host task, which is the largest
+ * stack_size of its basic tasks, plus RT_STACK_MIN for the host itself.
+ */
+size_t rt_basic_group_stack_size(const struct rt_basic_group *group);
+
+struct rt_basic_task
+{
+    void (*fn)(void);
+    const char *name;
+    size_t stack_size;
+    unsigned priority;
+    rt_atomic_uint activations;
+};
+
+/*
+ * stack_size is the worst-case stack usage of fn.
+ */
+#define RT_BASIC_TASK_INIT(name_, fn_, priority_, stack_size_)                 \
+    {                                                                          \
+        .fn = (fn_), .name = #name_, .stack_size = (stack_size_),              \
+        .priority = (priority_), .activations = 0,                             \
+    }
+
+#define RT_BASIC_TASK(name, fn, priority, stack_size)                          \
+    struct rt_basic_task name =                                                \
+        RT_BASIC_TASK_INIT(name, fn, priority, stack_size)
+
+struct rt_basic_group
+{
+    struct rt_sem sem;
+    struct rt_basic_task *const *tasks;
+    size_t num_tasks;
+};
+
+/*
+ * Define a group with the basic tasks given as pointers after name.
+ */
+#define RT_BASIC_GROUP_STATIC(name, ...)                                       \
+    static struct rt_basic_task *const name##_tasks[] = {__VA_ARGS__};         \
+    static struct rt_basic_group name = {                                      \
+        .sem = RT_SEM_INIT_BINARY(name.sem, 0),                                \
+        .tasks = name##_tasks,                                                 \
+        .num_tasks = sizeof name##_tasks / sizeof name##_tasks[0],             \
+    }
+
+#endif /* RT_BASIC_H */
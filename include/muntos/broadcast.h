@@ -0,0 +1,101 @@
+#ifndef RT_BROADCAST_H
+#define RT_BROADCAST_H
+
+/*
+ * A bounded publish-subscribe channel in which every subscriber receives every
+ * message published after it subscribes. Each message is stored once in a
+ * ring buffer, and each subscriber has its own read cursor into it. When the
+ * slowest subscriber has not yet read the oldest message in a full ring, a
+ * publish either overwrites it, and the subscriber counts the messages it
+ * missed as lost, or blocks, times out, or fails until that subscriber catches
+ * up, depending on the policy the channel was created with. Publishing,
+ * reading, and subscribing must be done from tasks.
+ */
+
+#include <muntos/cond.h>
+#include <muntos/list.h>
+#include <muntos/mutex.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+enum rt_broadcast_policy
+{
+    /* Overwrite the oldest message and count it as lost by subscribers that
+     * have not read it yet. */
+    RT_BROADCAST_OVERWRITE,
+
+    /* Wait for the slowest subscriber to read the oldest message. */
+    RT_BROADCAST_BLOCK,
+};
+
+struct rt_broadcast;
+struct rt_broadcast_sub;
+
+/*
+ * Add a subscriber to the channel. It will receive messages published after
+ * this call.
+ */
+void rt_broadcast_subscribe(struct rt_broadcast *bc,
+                            struct rt_broadcast_sub *sub);
+
+void rt_broadcast_unsubscribe(struct rt_broadcast_sub *sub);
+
+void rt_broadcast_publish(struct rt_broadcast *bc, const void *msg);
+
+bool rt_broadcast_trypublish(struct rt_broadcast *bc, const void *msg);
+
+bool rt_broadcast_timedpublish(struct rt_broadcast *bc, const void *msg,
+                               unsigned long ticks);
+
+/*
+ * Read the subscriber's next message. Only the task that owns a subscriber
+ * may read from it.
+ */
+void rt_broadcast_read(struct rt_broadcast_sub *sub, void *msg);
+
+bool rt_broadcast_tryread(struct rt_broadcast_sub *sub, void *msg);
+
+bool rt_broadcast_timedread(struct rt_broadcast_sub *sub, void *msg,
+                            unsigned long ticks);
+
+/*
+ * Get the number of messages that were overwritten before the subscriber read
+ * them.
+ */
+unsigned long rt_broadcast_lost(const struct rt_broadcast_sub *sub);
+
+struct rt_broadcast_sub
+{
+    struct rt_list list;
+    struct rt_broadcast *bc;
+    size_t cursor;
+    unsigned long lost;
+};
+
+struct rt_broadcast
+{
+    struct rt_mutex mutex;
+    struct rt_cond data_cond, space_cond;
+    struct rt_list subs;
+    void *data;
+    size_t num_elems, elem_size;
+    size_t head;
+    enum rt_broadcast_policy policy;
+};
+
+#define RT_BROADCAST_STATIC(name, type, num, policy_)                          \
+    static type name##_elems[(num)];                                           \
+    static struct rt_broadcast name = {                                        \
+        .mutex = RT_MUTEX_INIT(name.mutex),                                    \
+        .data_cond = RT_COND_INIT(name.data_cond),                             \
+        .space_cond = RT_COND_INIT(name.space_cond),                           \
+        .subs = RT_LIST_INIT(name.subs),                                       \
+        .data = name##_elems,                                                  \
+        .num_elems = (num),                                                    \
+        .elem_size = sizeof(type),                                             \
+        .head = 0,                                                             \
+        .policy = (policy_),                                                   \
+    }
+
+#endif /* RT_BROADCAST_H */
@@ -0,0 +1,15 @@
+#ifndef RT_CACHE_H
+#define RT_CACHE_H
+
+/*
+ * The cache line size used to separate fields that are written by different
+ * tasks or interrupts. The default of 1 adds no padding. Define this to the
+ * target's cache line size to keep those fields on separate lines.
+ */
+#ifndef RT_CACHE_LINE_SIZE
+#define RT_CACHE_LINE_SIZE 1
+#endif
+
+#define RT_CACHE_ALIGNED __attribute__((aligned(RT_CACHE_LINE_SIZE)))
+
+#endif /* RT_CACHE_H */
@@ -16,9 +16,24 @@ void rt_cond_broadcast(struct rt_cond *cond);
 
 void rt_cond_wait(struct rt_cond *cond, struct rt_mutex *mutex);
 
+/*
+ * Returns true if the condition variable was signaled before the timeout, in
+ * which case the mutex is held again. Returns false on timeout, in which case
+ * the mutex is not held. The timeout only covers waiting for the signal: once
+ * signaled, the task waits for the mutex without a timeout, like
+ * rt_mutex_lock, so the call can return true after the timeout has expired.
+ */
 bool rt_cond_timedwait(struct rt_cond *cond, struct rt_mutex *mutex,
                        unsigned long ticks);
 
+/*
+ * rt_cond_timedwait for whatever remains of a timeout of ticks that started at
+ * start_tick. If the timeout has already expired, this unlocks the mutex and
+ * returns false.
+ */
+bool rt_cond_timedwait_since(struct rt_cond *cond, struct rt_mutex *mutex,
+                             unsigned long start_tick, unsigned long ticks);
+
 struct rt_cond
 {
     struct rt_sem sem;
@@ -0,0 +1,190 @@
+#ifndef RT_CORO_H
+#define RT_CORO_H
+
+/*
+ * Stackless coroutines that all run on the stack of one host task. A
+ * coroutine is a function that is called again from the top each time it is
+ * resumed, and jumps to the wait point it last stopped at, so it only needs a
+ * few words of state rather than a stack of its own. Local variables are not
+ * preserved across wait points, so any state that must survive a wait should
+ * be kept in a structure that contains the struct rt_coro. Wait points may
+ * only appear in the coroutine function itself, not in functions it calls,
+ * and the function may not contain a switch statement around a wait point.
+ *
+ * Coroutines wait on semaphores and queues by polling their try operations.
+ * Each semaphore that a coroutine waits on must first be added to its host,
+ * which makes every post to it wake the host task, and the host runs all of
+ * its coroutines whenever it wakes. A semaphore added to a host must not be
+ * waited on by a task or added to a select set.
+ *
+ * A queue has a semaphore for each side, and the host only takes the side
+ * that its coroutines wait on. A queue added for popping gives the host the
+ * queue's pop semaphore, so tasks may still push to the queue, and may block
+ * while it is full, but must not pop from it. A queue added for pushing gives
+ * the host the push semaphore, so tasks may pop from the queue but must not
+ * push to it.
+ *
+ *     static void blink(struct rt_coro *coro)
+ *     {
+ *         RT_CORO_BEGIN(coro);
+ *         while (enabled)
+ *         {
+ *             RT_CORO_SEM_WAIT(coro, &button);
+ *             toggle_led();
+ *             RT_CORO_SLEEP(coro, 10);
+ *         }
+ *         RT_CORO_END(coro);
+ *     }
+ */
+
+#include <muntos/list.h>
+#include <muntos/queue.h>
+#include <muntos/select.h>
+#include <muntos/sem.h>
+#include <muntos/tick.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct rt_coro;
+struct rt_coro_host;
+
+void rt_coro_init(struct rt_coro *coro, void (*fn)(struct rt_coro *),
+                  const char *name);
+
+/*
+ * Add a coroutine to a host. This may be called before the host task starts
+ * or from a coroutine running on the same host.
+ */
+void rt_coro_host_add(struct rt_coro_host *host, struct rt_coro *coro);
+
+/*
+ * Allow coroutines on the host to wait on a semaphore. Returns false if the
+ * host can't watch any more objects.
+ */
+bool rt_coro_host_add_sem(struct rt_coro_host *host, struct rt_sem *sem);
+
+/*
+ * Allow coroutines on the host to pop from a queue, or to push to a queue.
+ * Each uses one of the host's object slots. A queue whose both sides are
+ * used by coroutines on the host must be added with both.
+ */
+bool rt_coro_host_add_queue_pop(struct rt_coro_host *host,
+                                struct rt_queue *queue);
+
+bool rt_coro_host_add_queue_push(struct rt_coro_host *host,
+                                 struct rt_queue *queue);
+
+/*
+ * The task function of a host. arg is a pointer to the struct rt_coro_host,
+ * e.g., RT_TASK_ARG(rt_coro_host_run, (uintptr_t)&host, ...). The host runs
+ * each of its coroutines in the order they were added until it reaches a wait
+ * point that isn't ready, and blocks when none of them can make progress.
+ * Coroutines that reach RT_CORO_END are removed from the host.
+ */
+void rt_coro_host_run(uintptr_t arg);
+
+/*
+ * Used by RT_CORO_SLEEP to check whether a coroutine's sleep has elapsed.
+ */
+bool rt_coro_woken(struct rt_coro *coro);
+
+struct rt_coro
+{
+    struct rt_list list;
+    void (*fn)(struct rt_coro *);
+    const char *name;
+    unsigned long sleep_start, sleep_ticks;
+    int line;
+    bool sleeping, yielded;
+};
+
+#define RT_CORO_INIT(name_, fn_)                                               \
+    {                                                                          \
+        .list = RT_LIST_INIT(name_.list), .fn = (fn_), .name = #name_,         \
+        .sleep_start = 0, .sleep_ticks = 0, .line = 0, .sleeping = false,      \
+        .yielded = false,                                                      \
+    }
+
+#define RT_CORO(name, fn) struct rt_coro name = RT_CORO_INIT(name, fn)
+
+struct rt_coro_host
+{
+    struct rt_select set;
+    struct rt_list coros;
+};
+
+#define RT_CORO_HOST_STATIC(name, max_objects)                                 \
+    static struct rt_select_member name##_members[(max_objects)];              \
+    static struct rt_coro_host name = {                                        \
+        .set =                                                                 \
+            {                                                                  \
+                .sem = RT_SEM_INIT(name.set.sem, 0),                           \
+                .members = name##_members,                                     \
+                .num_members = 0,                                              \
+                .max_members = (max_objects),                                  \
+            },                                                                 \
+        .coros = RT_LIST_INIT(name.coros),                                     \
+    }
+
+#define RT_CORO_DONE (-1)
+
+/*
+ * Begin and end the body of a coroutine function.
+ */
+#define RT_CORO_BEGIN(coro)                                                    \
+    switch ((coro)->line)                                                      \
+    {                                                                          \
+    case 0:
+
+#define RT_CORO_END(coro)                                                      \
+    }                                                                          \
+    (coro)->line = RT_CORO_DONE;                                               \
+    return
+
+/*
+ * Return to the host until cond is true. cond is evaluated each time the
+ * coroutine is resumed.
+ */
+#define RT_CORO_WAIT_UNTIL(coro, cond)                                         \
+    do                                                                         \
+    {                                                                          \
+        (coro)->line = __LINE__;                                               \
+        __attribute__((fallthrough));                                          \
+    case __LINE__:                                                             \
+        if (!(cond))                                                           \
+        {                                                                      \
+            return;                                                            \
+        }                                                                      \
+    } while (0)
+
+/*
+ * Return to the host and resume after every other coroutine has run.
+ */
+#define RT_CORO_YIELD(coro)                                                    \
+    do                                                                         \
+    {                                                                          \
+        (coro)->line = __LINE__;                                               \
+        (coro)->yielded = true;                                                \
+        return;                                                                \
+    case __LINE__:;                                                            \
+    } while (0)
+
+#define RT_CORO_SLEEP(coro, ticks)                                             \
+    do                                                                         \
+    {                                                                          \
+        (coro)->sleep_start = rt_tick();                                       \
+        (coro)->sleep_ticks = (ticks);                                         \
+        RT_CORO_WAIT_UNTIL(coro, rt_coro_woken(coro));                         \
+    } while (0)
+
+#define RT_CORO_SEM_WAIT(coro, sem)                                            \
+    RT_CORO_WAIT_UNTIL(coro, rt_sem_trywait(sem))
+
+#define RT_CORO_QUEUE_PUSH(coro, queue, elem)                                  \
+    RT_CORO_WAIT_UNTIL(coro, rt_queue_trypush((queue), (elem)))
+
+#define RT_CORO_QUEUE_POP(coro, queue, elem)                                   \
+    RT_CORO_WAIT_UNTIL(coro, rt_queue_trypop((queue), (elem)))
+
+#endif /* RT_CORO_H */
@@ -0,0 +1,108 @@
+#ifndef RT_EVENT_GROUP_H
+#define RT_EVENT_GROUP_H
+
+/*
+ * An event group is a set of 32 event bits that any number of tasks can wait
+ * on. Each waiter waits for any or all of the bits in a mask to be set, and
+ * can clear those bits when its wait is satisfied. Setting bits evaluates
+ * every waiter's condition in the system call handler in one pass, in
+ * priority order, so only the tasks whose conditions are met are woken. Bits
+ * may be set, cleared, and read from tasks or interrupts.
+ */
+
+#include <muntos/atomic.h>
+#include <muntos/list.h>
+#include <muntos/syscall.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct rt_event_group;
+
+enum rt_event_group_flags
+{
+    /* Wait for all of the bits in the mask rather than any of them. */
+    RT_EVENT_GROUP_WAIT_ALL = 1 << 0,
+
+    /* Clear the bits in the mask when the wait is satisfied. */
+    RT_EVENT_GROUP_CLEAR = 1 << 1,
+};
+
+void rt_event_group_init(struct rt_event_group *group, uint32_t bits);
+
+/*
+ * Set bits and wake the tasks whose conditions are now met. Returns the bits
+ * before setting.
+ */
+uint32_t rt_event_group_set(struct rt_event_group *group, uint32_t bits);
+
+/*
+ * Clear bits. Returns the bits before clearing.
+ */
+uint32_t rt_event_group_clear(struct rt_event_group *group, uint32_t bits);
+
+uint32_t rt_event_group_get(const struct rt_event_group *group);
+
+/*
+ * Block until any, or with RT_EVENT_GROUP_WAIT_ALL all, of the bits in mask
+ * are set, and return the bits that satisfied the wait, before any clearing.
+ */
+uint32_t rt_event_group_wait(struct rt_event_group *group, uint32_t mask,
+                             unsigned flags);
+
+/*
+ * Like rt_event_group_wait, but return false if the wait can't be satisfied
+ * immediately. On success, *bits is set to the bits that satisfied the wait.
+ */
+bool rt_event_group_trywait(struct rt_event_group *group, uint32_t mask,
+                            unsigned flags, uint32_t *bits);
+
+/*
+ * Like rt_event_group_trywait, but block for up to ticks for the wait to be
+ * satisfied. Bits are not cleared if the wait times out.
+ */
+bool rt_event_group_timedwait(struct rt_event_group *group, uint32_t mask,
+                              unsigned flags, uint32_t *bits,
+                              unsigned long ticks);
+
+struct rt_event_group
+{
+    rt_atomic_uint32_t bits;
+    struct rt_list wait_list;
+    rt_atomic_size_t num_waiters;
+    struct rt_syscall_record set_record;
+    rt_atomic_flag set_pending;
+};
+
+#define RT_EVENT_GROUP_INIT(name, bits_)                                       \
+    {                                                                          \
+        .bits = (bits_), .wait_list = RT_LIST_INIT(name.wait_list),            \
+        .num_waiters = 0,                                                      \
+        .set_record =                                                          \
+            {                                                                  \
+                .next = NULL,                                                  \
+                .args.event_group_set.group = &name,                           \
+                .syscall = RT_SYSCALL_EVENT_GROUP_SET,                         \
+            },                                                                 \
+        .set_pending = RT_ATOMIC_FLAG_INIT,                                    \
+    }
+
+#define RT_EVENT_GROUP(name, bits)                                             \
+    struct rt_event_group name = RT_EVENT_GROUP_INIT(name, bits)
+
+/*
+ * Returns true if bits satisfy a wait for mask with flags. This is shared by
+ * the wait fast path and the system call handler.
+ */
+static inline bool rt_event_group_satisfied(uint32_t bits, uint32_t mask,
+                                            unsigned flags)
+{
+    if ((flags & RT_EVENT_GROUP_WAIT_ALL) != 0)
+    {
+        return (bits & mask) == mask;
+    }
+    return (bits & mask) != 0;
+}
+
+#endif /* RT_EVENT_GROUP_H */
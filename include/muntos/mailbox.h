@@ -0,0 +1,82 @@
+#ifndef RT_MAILBOX_H
+#define RT_MAILBOX_H
+
+/*
+ * A mailbox that holds the latest value written to it, using a lock-free
+ * triple buffer. At most one task/interrupt may write and at most one
+ * task/interrupt may read at a time. The writer and reader each own one of
+ * three buffers, and the third holds the latest complete value. A write fills
+ * the writer's buffer and swaps it with the latest one, so it always succeeds
+ * without blocking and overwrites any value that hasn't been read. A read
+ * swaps the latest buffer with the reader's if it holds a new value, so the
+ * reader always gets the most recent complete value, and neither side waits
+ * on the other. A write only posts the semaphore when a reader is blocked
+ * waiting for a new value.
+ */
+
+#include <muntos/atomic.h>
+#include <muntos/sem.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+struct rt_mailbox;
+
+void rt_mailbox_write(struct rt_mailbox *mailbox, const void *elem);
+
+/*
+ * Copy the most recent value written to the mailbox, or the initial value if
+ * there has been no write. Returns true if the value is new since the last
+ * read.
+ */
+bool rt_mailbox_read(struct rt_mailbox *mailbox, void *elem);
+
+/*
+ * Copy the most recent value if it is new since the last read. Returns false
+ * and leaves elem unchanged if there is no new value.
+ */
+bool rt_mailbox_tryread(struct rt_mailbox *mailbox, void *elem);
+
+/*
+ * Block until there is a new value and copy it.
+ */
+void rt_mailbox_wait(struct rt_mailbox *mailbox, void *elem);
+
+/*
+ * Wait for a new value until a timeout expires and copy it. Returns false if
+ * there is no new value before the timeout expires.
+ */
+bool rt_mailbox_timedwait(struct rt_mailbox *mailbox, void *elem,
+                          unsigned long ticks);
+
+struct rt_mailbox
+{
+    /* The index of the buffer with the latest value, and RT_MAILBOX_NEW if it
+     * has not been read. */
+    rt_atomic_uchar latest;
+    unsigned char write_index, read_index;
+    rt_atomic_bool waiting;
+    struct rt_sem sem;
+    void *data;
+    size_t elem_size;
+};
+
+#define RT_MAILBOX_NEW 0x4U
+#define RT_MAILBOX_INDEX_MASK 0x3U
+
+/*
+ * The initial value of the mailbox is zero.
+ */
+#define RT_MAILBOX_STATIC(name, type)                                          \
+    static type name##_elems[3];                                               \
+    static struct rt_mailbox name = {                                          \
+        .latest = 0,                                                           \
+        .write_index = 1,                                                      \
+        .read_index = 2,                                                       \
+        .waiting = false,                                                      \
+        .sem = RT_SEM_INIT_BINARY(name.sem, 0),                                \
+        .data = name##_elems,                                                  \
+        .elem_size = sizeof(type),                                             \
+    }
+
+#endif /* RT_MAILBOX_H */
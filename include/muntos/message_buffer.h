@@ -0,0 +1,98 @@
+#ifndef RT_MESSAGE_BUFFER_H
+#define RT_MESSAGE_BUFFER_H
+
+/*
+ * A bounded, single-sender, single-receiver buffer of variable-length
+ * messages that supports blocking, timed, and non-blocking send, receive, and
+ * peek. At most one task/interrupt may send and at most one task/interrupt may
+ * receive or peek at a time. Each message is stored contiguously in one byte
+ * arena behind a length prefix, so messages only use as much space as they
+ * need and can be read in place. A message may be at most
+ * RT_MESSAGE_BUFFER_MAX_LEN(size) bytes long. The size of the arena must be a
+ * power of two.
+ */
+
+#include <muntos/atomic.h>
+#include <muntos/cache.h>
+#include <muntos/sem.h>
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+struct rt_message_buffer;
+
+void rt_message_buffer_send(struct rt_message_buffer *mb, const void *data,
+                            size_t len);
+
+bool rt_message_buffer_trysend(struct rt_message_buffer *mb, const void *data,
+                               size_t len);
+
+bool rt_message_buffer_timedsend(struct rt_message_buffer *mb,
+                                 const void *data, size_t len,
+                                 unsigned long ticks);
+
+/*
+ * Receive the next message and return its length. If the message is longer
+ * than max_len, only its first max_len bytes are copied out.
+ */
+size_t rt_message_buffer_receive(struct rt_message_buffer *mb, void *data,
+                                 size_t max_len);
+
+bool rt_message_buffer_tryreceive(struct rt_message_buffer *mb, void *data,
+                                  size_t max_len, size_t *len);
+
+bool rt_message_buffer_timedreceive(struct rt_message_buffer *mb, void *data,
+                                    size_t max_len, size_t *len,
+                                    unsigned long ticks);
+
+/*
+ * Return a pointer to the next message in the arena and its length without
+ * removing it. The pointer remains valid until the message is received. The
+ * try and timed variants return NULL on failure.
+ */
+const void *rt_message_buffer_peek(struct rt_message_buffer *mb, size_t *len);
+
+const void *rt_message_buffer_trypeek(struct rt_message_buffer *mb,
+                                      size_t *len);
+
+const void *rt_message_buffer_timedpeek(struct rt_message_buffer *mb,
+                                        size_t *len, unsigned long ticks);
+
+struct rt_message_buffer
+{
+    /* Sender-side fields. */
+    struct rt_sem send_sem RT_CACHE_ALIGNED;
+    rt_atomic_size_t head;
+
+    /* Receiver-side fields. */
+    struct rt_sem recv_sem RT_CACHE_ALIGNED;
+    rt_atomic_size_t tail;
+
+    unsigned char *arena RT_CACHE_ALIGNED;
+    size_t mask;
+};
+
+/*
+ * Each message is prefixed by its length and padded to the alignment of the
+ * length, and must fit in half of the arena so that a message that doesn't
+ * fit before the end of the arena can always be placed at the start instead.
+ */
+#define RT_MESSAGE_BUFFER_MAX_LEN(size) ((size) / 2 - sizeof(size_t))
+
+#define RT_MESSAGE_BUFFER_STATIC(name, size)                                   \
+    static_assert(((size) > 0) && (((size) & ((size)-1)) == 0),                \
+                  "message buffer size must be a power of two");               \
+    static_assert((size) >= 4 * sizeof(size_t),                                \
+                  "message buffer is too small");                              \
+    static size_t name##_arena[(size) / sizeof(size_t)];                       \
+    static struct rt_message_buffer name = {                                   \
+        .send_sem = RT_SEM_INIT_BINARY(name.send_sem, 0),                      \
+        .head = 0,                                                             \
+        .recv_sem = RT_SEM_INIT(name.recv_sem, 0),                             \
+        .tail = 0,                                                             \
+        .arena = (unsigned char *)name##_arena,                                \
+        .mask = (size)-1,                                                      \
+    }
+
+#endif /* RT_MESSAGE_BUFFER_H */
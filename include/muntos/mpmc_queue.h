@@ -0,0 +1,105 @@
+#ifndef RT_MPMC_QUEUE_H
+#define RT_MPMC_QUEUE_H
+
+/*
+ * A multi-producer, multi-consumer, lock-free linked queue in the style of
+ * Michael and Scott, whose nodes come from a fixed pool owned by the queue.
+ * Unlike rt_queue, any number of tasks/interrupts may operate on the queue at
+ * once, and a push never blocks: it fails only when every node in the pool is
+ * in use. Consumers may block on a semaphore that counts the elements in the
+ * queue.
+ *
+ * Nodes are referred to by index, and every link is tagged with a count of
+ * the updates made to it, so that a node that is freed and reused while
+ * another operation holds a stale link to it is detected. Each queue uses
+ * only as many index bits as its pool needs, and the tag gets the rest, so
+ * small queues have tags that take much longer to wrap around. The pool is a
+ * lock-free stack of free nodes, plus the nodes that have never been used,
+ * so it needs no initialization.
+ */
+
+#include <muntos/atomic.h>
+#include <muntos/cache.h>
+#include <muntos/sem.h>
+
+#include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+struct rt_mpmc_queue;
+
+/*
+ * Push an element. Returns false if the node pool is exhausted.
+ */
+bool rt_mpmc_queue_push(struct rt_mpmc_queue *queue, const void *elem);
+
+void rt_mpmc_queue_pop(struct rt_mpmc_queue *queue, void *elem);
+
+bool rt_mpmc_queue_trypop(struct rt_mpmc_queue *queue, void *elem);
+
+bool rt_mpmc_queue_timedpop(struct rt_mpmc_queue *queue, void *elem,
+                            unsigned long ticks);
+
+struct rt_mpmc_queue
+{
+    /* Consumer-side fields. */
+    struct rt_sem sem RT_CACHE_ALIGNED;
+    rt_atomic_size_t head;
+
+    /* Producer-side fields. */
+    rt_atomic_size_t tail RT_CACHE_ALIGNED;
+
+    /* Node pool fields. */
+    rt_atomic_size_t free RT_CACHE_ALIGNED;
+    rt_atomic_size_t unused;
+
+    rt_atomic_size_t *next;
+    void *data;
+    size_t num_nodes, elem_size;
+    unsigned char index_bits;
+};
+
+/*
+ * Links store one more than a node's index in the low index_bits bits of a
+ * size_t, so that zero is the null link, and the tag in the remaining bits.
+ * The size of a queue is limited so that every tag has at least
+ * RT_MPMC_QUEUE_MIN_TAG_BITS bits.
+ */
+#define RT_MPMC_QUEUE_SIZE_BITS (sizeof(size_t) * CHAR_BIT)
+#define RT_MPMC_QUEUE_MIN_TAG_BITS (RT_MPMC_QUEUE_SIZE_BITS / 2)
+#define RT_MPMC_QUEUE_MAX_SIZE                                                 \
+    (((size_t)1                                                                \
+      << (RT_MPMC_QUEUE_SIZE_BITS - RT_MPMC_QUEUE_MIN_TAG_BITS)) -             \
+     2)
+
+/*
+ * The number of bits needed to hold the node numbers 1 to num + 1.
+ */
+#define RT_MPMC_QUEUE_INDEX_BITS_FOR(num)                                      \
+    ((unsigned char)(sizeof(unsigned long long) * CHAR_BIT -                   \
+                     (size_t)__builtin_clzll((unsigned long long)(num) + 1)))
+
+/*
+ * The queue holds up to num elements. The pool has one extra node, because
+ * the node at the head of the queue is always a placeholder whose element
+ * has already been popped. The first node is the initial placeholder.
+ */
+#define RT_MPMC_QUEUE_STATIC(name, type, num)                                  \
+    static_assert((num) <= RT_MPMC_QUEUE_MAX_SIZE, "queue is too large");      \
+    static type name##_elems[(num) + 1];                                       \
+    static rt_atomic_size_t name##_next[(num) + 1];                            \
+    static struct rt_mpmc_queue name = {                                       \
+        .sem = RT_SEM_INIT(name.sem, 0),                                       \
+        .head = 1,                                                             \
+        .tail = 1,                                                             \
+        .free = 0,                                                             \
+        .unused = 1,                                                           \
+        .next = name##_next,                                                   \
+        .data = name##_elems,                                                  \
+        .num_nodes = (num) + 1,                                                \
+        .elem_size = sizeof(type),                                             \
+        .index_bits = RT_MPMC_QUEUE_INDEX_BITS_FOR(num),                       \
+    }
+
+#endif /* RT_MPMC_QUEUE_H */
@@ -0,0 +1,68 @@
+#ifndef RT_PRIO_QUEUE_H
+#define RT_PRIO_QUEUE_H
+
+/*
+ * A queue that pops the element with the highest priority first, and elements
+ * of the same priority in the order they were pushed. Each priority level is
+ * a separate rt_queue, and a semaphore counts the elements across all levels.
+ * A push goes directly to its level's queue, so it blocks, times out, or fails
+ * only if that level is full. A pop takes a count from the semaphore and then
+ * tries each level from the highest, so it takes time proportional to the
+ * number of levels, not the number of elements queued. With a single popper,
+ * a pop makes one pass over the levels. With several poppers, a pass can miss
+ * an element that another popper takes during it, and the pop then makes
+ * another pass, at most one for each pop that completes in the meantime. All
+ * level queues must have the same element type, and must not be used except
+ * through the priority queue.
+ */
+
+#include <muntos/queue.h>
+#include <muntos/sem.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+struct rt_prio_queue;
+
+/*
+ * Push an element at a priority, which is the index of a level. Higher
+ * priorities are popped first. A priority at or above the number of levels is
+ * pushed at the highest level.
+ */
+void rt_prio_queue_push(struct rt_prio_queue *queue, size_t priority,
+                        const void *elem);
+
+void rt_prio_queue_pop(struct rt_prio_queue *queue, void *elem);
+
+bool rt_prio_queue_trypush(struct rt_prio_queue *queue, size_t priority,
+                           const void *elem);
+
+bool rt_prio_queue_trypop(struct rt_prio_queue *queue, void *elem);
+
+bool rt_prio_queue_timedpush(struct rt_prio_queue *queue, size_t priority,
+                             const void *elem, unsigned long ticks);
+
+bool rt_prio_queue_timedpop(struct rt_prio_queue *queue, void *elem,
+                            unsigned long ticks);
+
+struct rt_prio_queue
+{
+    struct rt_sem sem;
+    struct rt_queue *const *levels;
+    size_t num_levels;
+};
+
+/*
+ * Define a priority queue with the level queues given as pointers after name,
+ * from the lowest priority to the highest. Each level can have its own
+ * capacity.
+ */
+#define RT_PRIO_QUEUE_STATIC(name, ...)                                        \
+    static struct rt_queue *const name##_levels[] = {__VA_ARGS__};             \
+    static struct rt_prio_queue name = {                                       \
+        .sem = RT_SEM_INIT(name.sem, 0),                                       \
+        .levels = name##_levels,                                               \
+        .num_levels = sizeof name##_levels / sizeof name##_levels[0],          \
+    }
+
+#endif /* RT_PRIO_QUEUE_H */
@@ -12,6 +12,7 @@
  */
 
 #include <muntos/atomic.h>
+#include <muntos/cache.h>
 #include <muntos/sem.h>
 
 #include <assert.h>
@@ -41,14 +42,57 @@ bool rt_queue_timedpop(struct rt_queue *queue, void *elem, unsigned long ticks);
 bool rt_queue_timedpeek(struct rt_queue *queue, void *elem,
                         unsigned long ticks);
 
+/*
+ * Claim an empty slot and return a pointer to its element, so the element can
+ * be written in place rather than copied in by push. The element is not
+ * visible to poppers until it is passed to rt_queue_commit. If a popper
+ * overtakes a reserved slot, the element is published in a later pass over
+ * the queue, so it may be popped after elements pushed by the same task once
+ * it is committed. The try and timed variants return NULL on failure.
+ */
+void *rt_queue_reserve(struct rt_queue *queue);
+
+void *rt_queue_tryreserve(struct rt_queue *queue);
+
+void *rt_queue_timedreserve(struct rt_queue *queue, unsigned long ticks);
+
+/*
+ * Publish an element returned by rt_queue_*reserve.
+ */
+void rt_queue_commit(struct rt_queue *queue, void *elem);
+
+/*
+ * Claim the next full slot and return a pointer to its element, so the
+ * element can be read in place rather than copied out by pop. The slot is not
+ * reused until the element is passed to rt_queue_release. The try and timed
+ * variants return NULL on failure.
+ */
+void *rt_queue_acquire(struct rt_queue *queue);
+
+void *rt_queue_tryacquire(struct rt_queue *queue);
+
+void *rt_queue_timedacquire(struct rt_queue *queue, unsigned long ticks);
+
+/*
+ * Return a slot claimed by rt_queue_*acquire to the queue.
+ */
+void rt_queue_release(struct rt_queue *queue, void *elem);
+
 struct rt_queue
 {
-    struct rt_sem push_sem;
-    struct rt_sem pop_sem;
-    rt_atomic_size_t enq, deq;
-    rt_atomic_uchar *slots;
+    /* Pusher-side fields. */
+    struct rt_sem push_sem RT_CACHE_ALIGNED;
+    rt_atomic_size_t enq;
+
+    /* Popper-side fields. */
+    struct rt_sem pop_sem RT_CACHE_ALIGNED;
+    rt_atomic_size_t deq;
+
+    rt_atomic_uchar *slots RT_CACHE_ALIGNED;
     void *data;
     size_t num_elems, elem_size;
+    size_t slot_stride, elem_stride;
+    unsigned char index_bits;
 };
 
 #define RT_QUEUE_STATE_BITS 4
@@ -57,19 +101,48 @@ struct rt_queue
 #define RT_QUEUE_INDEX_BITS (RT_QUEUE_SIZE_BITS - RT_QUEUE_GEN_BITS)
 #define RT_QUEUE_MAX_SIZE (((size_t)1 << RT_QUEUE_INDEX_BITS) - 1)
 
+/*
+ * Queues with a power-of-two number of elements only use as many index bits
+ * as they need, so that advancing an index wraps it by masking.
+ */
+#define RT_QUEUE_INDEX_BITS_FOR(num)                                           \
+    ((((num) & ((num)-1)) == 0)                                                \
+         ? (unsigned char)__builtin_ctzll((unsigned long long)(num))           \
+         : (unsigned char)RT_QUEUE_INDEX_BITS)
+
+#define RT_QUEUE_INIT(name, num, size, slots_, slot_stride_, data_,            \
+                      elem_stride_)                                            \
+    {                                                                          \
+        .push_sem = RT_SEM_INIT(name.push_sem, (num)), .enq = 0,               \
+        .pop_sem = RT_SEM_INIT(name.pop_sem, 0), .deq = 0, .slots = (slots_),  \
+        .data = (data_), .num_elems = (num), .elem_size = (size),              \
+        .slot_stride = (slot_stride_), .elem_stride = (elem_stride_),          \
+        .index_bits = RT_QUEUE_INDEX_BITS_FOR(num),                            \
+    }
+
 #define RT_QUEUE_STATIC(name, type, num)                                       \
     static_assert((num) <= RT_QUEUE_MAX_SIZE, "queue is too large");           \
     static type name##_elems[(num)];                                           \
     static rt_atomic_uchar name##_slots[(num)];                                \
-    static struct rt_queue name = {                                            \
-        .push_sem = RT_SEM_INIT(name.push_sem, (num)),                         \
-        .pop_sem = RT_SEM_INIT(name.pop_sem, 0),                               \
-        .enq = 0,                                                              \
-        .deq = 0,                                                              \
-        .slots = name##_slots,                                                 \
-        .data = name##_elems,                                                  \
-        .num_elems = (num),                                                    \
-        .elem_size = sizeof(type),                                             \
-    }
+    static struct rt_queue name =                                              \
+        RT_QUEUE_INIT(name, (num), sizeof(type), name##_slots,                 \
+                      sizeof name##_slots[0], name##_elems, sizeof(type))
+
+/*
+ * Like RT_QUEUE_STATIC, but store each slot's state next to its element, so
+ * that each queue operation touches one cache line rather than two, at the
+ * cost of padding each state byte out to the alignment of type.
+ */
+#define RT_QUEUE_STATIC_INTERLEAVED(name, type, num)                           \
+    static_assert((num) <= RT_QUEUE_MAX_SIZE, "queue is too large");           \
+    static struct                                                              \
+    {                                                                          \
+        rt_atomic_uchar slot;                                                  \
+        type elem;                                                             \
+    } name##_cells[(num)];                                                     \
+    static struct rt_queue name =                                              \
+        RT_QUEUE_INIT(name, (num), sizeof(type), &name##_cells[0].slot,        \
+                      sizeof name##_cells[0], &name##_cells[0].elem,           \
+                      sizeof name##_cells[0])
 
 #endif /* RT_QUEUE_H */
@@ -0,0 +1,95 @@
+#ifndef RT_RCU_H
+#define RT_RCU_H
+
+/*
+ * Read-copy-update for data that is read far more often than it is written.
+ * Readers access the current version of the data through an atomic pointer
+ * inside a read-side critical section, and never block or enter the kernel.
+ * A writer copies the current version, modifies the copy, publishes it with
+ * a store-release to the pointer, and then must wait for a grace period
+ * before freeing the old version, either by calling rt_rcu_synchronize or by
+ * deferring the free with rt_rcu_call.
+ *
+ *     rt_rcu_read_lock();
+ *     const struct table *t =
+ *         rt_atomic_load_explicit(&current, memory_order_acquire);
+ *     ... use t ...
+ *     rt_rcu_read_unlock();
+ *
+ * Each task counts its own read-side critical section depth with plain
+ * increments and decrements, so on a single core a read-side critical section
+ * costs two non-atomic updates of the current task, and no atomic
+ * read-modify-writes. When the scheduler switches out a task that is inside a
+ * read-side critical section, it counts the task in the current grace period,
+ * and the task uncounts itself when it leaves the critical section. A grace
+ * period only waits for the tasks counted before it started, so readers that
+ * start during a grace period never delay it. Grace periods are shared by all
+ * data protected with RCU. Read-side critical sections may be nested, and may
+ * be used in interrupts, which always end them before any task runs, but must
+ * not block.
+ */
+
+#include <muntos/atomic.h>
+#include <muntos/sem.h>
+
+#include <stdint.h>
+
+struct rt_rcu;
+
+struct rt_rcu_head;
+
+void rt_rcu_init(struct rt_rcu *rcu);
+
+/*
+ * Begin and end a read-side critical section.
+ */
+void rt_rcu_read_lock(void);
+
+void rt_rcu_read_unlock(void);
+
+/*
+ * Wait until every read-side critical section that started before the call
+ * has ended. This may only be called by a task, and not from a read-side
+ * critical section.
+ */
+void rt_rcu_synchronize(void);
+
+/*
+ * Run fn(head) in the background after a grace period, e.g., to free the
+ * structure containing head. This is lock-free and may be called from
+ * interrupts. Requires a task running rt_rcu_reclaimer for the same struct
+ * rt_rcu, which only holds the pending callbacks.
+ */
+void rt_rcu_call(struct rt_rcu *rcu, struct rt_rcu_head *head,
+                 void (*fn)(struct rt_rcu_head *));
+
+/*
+ * The task function that runs callbacks passed to rt_rcu_call. arg is a
+ * pointer to the struct rt_rcu, e.g.,
+ * RT_TASK_ARG(rt_rcu_reclaimer, (uintptr_t)&rcu, ...). Each pass takes all
+ * pending callbacks, waits for one grace period, and runs them in the order
+ * they were passed to rt_rcu_call.
+ */
+void rt_rcu_reclaimer(uintptr_t arg);
+
+struct rt_rcu_head
+{
+    struct rt_rcu_head *next;
+    void (*fn)(struct rt_rcu_head *);
+};
+
+struct rt_rcu
+{
+    struct rt_rcu_head *_Atomic callbacks;
+    struct rt_sem callback_sem;
+};
+
+#define RT_RCU_INIT(name)                                                      \
+    {                                                                          \
+        .callbacks = NULL,                                                     \
+        .callback_sem = RT_SEM_INIT_BINARY(name.callback_sem, 0),              \
+    }
+
+#define RT_RCU(name) struct rt_rcu name = RT_RCU_INIT(name)
+
+#endif /* RT_RCU_H */
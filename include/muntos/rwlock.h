@@ -1,8 +1,18 @@
 #ifndef RT_RWLOCK_H
 #define RT_RWLOCK_H
 
-#include <muntos/cond.h>
+/*
+ * A reader-writer lock whose reader state lives in one atomic word, so that
+ * readers only make an atomic update of that word when no writer is active or
+ * waiting, and a writer only takes an uncontended mutex and updates that word
+ * when no readers are active. Tasks block on semaphores only under
+ * contention. Writers are preferred: once a writer is waiting, new readers
+ * block until it has unlocked.
+ */
+
+#include <muntos/atomic.h>
 #include <muntos/mutex.h>
+#include <muntos/sem.h>
 
 struct rt_rwlock;
 
@@ -18,15 +28,24 @@ void rt_rwlock_wunlock(struct rt_rwlock *lock);
 
 struct rt_rwlock
 {
-    struct rt_mutex m;
-    struct rt_cond rcond, wcond;
-    int num_readers, num_writers;
+    /* The number of readers that hold or are waiting for the lock, minus
+     * RT_RWLOCK_WRITER if a writer holds or is waiting for it. */
+    rt_atomic_int readers;
+
+    /* The number of readers a waiting writer is still waiting for. */
+    rt_atomic_int departing;
+
+    struct rt_sem rsem, wsem;
+    struct rt_mutex wmutex;
 };
 
+#define RT_RWLOCK_WRITER (1 << 30)
+
 #define RT_RWLOCK_INIT(name)                                                   \
     {                                                                          \
-        .m = RT_MUTEX_INIT(name.m), .rcond = RT_COND_INIT(name.rcond),         \
-        .wcond = RT_COND_INIT(name.wcond), .num_readers = 0, .num_writers = 0, \
+        .readers = 0, .departing = 0, .rsem = RT_SEM_INIT(name.rsem, 0),       \
+        .wsem = RT_SEM_INIT(name.wsem, 0),                                     \
+        .wmutex = RT_MUTEX_INIT(name.wmutex),                                  \
     }
 
 #define RT_RWLOCK(name) struct rt_rwlock name = RT_RWLOCK_INIT(name)
@@ -0,0 +1,34 @@
+#ifndef RT_SCHED_H
+#define RT_SCHED_H
+
+#include <stdbool.h>
+
+/*
+ * Lock the scheduler, so that the current task keeps running and system calls
+ * made by it or by interrupts are deferred until the scheduler is unlocked.
+ * Posts and other operations that would wake tasks take effect in one pass
+ * when the scheduler is unlocked, so a burst of them causes at most one
+ * context switch. Locks nest, and the scheduler is unlocked when each lock has
+ * been matched by an unlock. The lock isn't owned by the task, so the task
+ * that locks the scheduler must also unlock it, and must not wait, sleep, or
+ * exit in between. The kernel asserts this, because the scheduler never
+ * switches away from the running task while it is locked.
+ *
+ * Posts, sets, notifications, timer commands, and suspends or resumes of
+ * other tasks are deferred as above. rt_task_yield, rt_task_set_priority,
+ * and rt_task_set_priorities are handled immediately, but the current task
+ * keeps running, and any switch they cause happens at the outermost unlock.
+ * rt_task_suspend of the current task is also handled immediately, and the
+ * task stops running at the outermost unlock unless it has been resumed by
+ * then.
+ */
+void rt_sched_lock(void);
+
+void rt_sched_unlock(void);
+
+/*
+ * Returns true if the scheduler is locked.
+ */
+bool rt_sched_is_locked(void);
+
+#endif /* RT_SCHED_H */
@@ -0,0 +1,70 @@
+#ifndef RT_SELECT_H
+#define RT_SELECT_H
+
+/*
+ * A select set lets one task block until any of several semaphores, queues,
+ * or notifications is ready. Each post to a member also posts the set's own
+ * semaphore, so no posts are missed between checks. Members are checked in
+ * the order they were added, so earlier members take precedence when several
+ * are ready.
+ *
+ * A member must be added before it is posted to. After that, it must only be
+ * consumed by the task that waits on the set, using its try operations after
+ * rt_select_*wait returns it, and no task may block on it directly. Only one
+ * task may wait on each set.
+ */
+
+#include <muntos/sem.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+struct rt_select;
+struct rt_queue;
+struct rt_notify;
+
+/*
+ * Add a semaphore to the set. Returns false if the set is full.
+ */
+bool rt_select_add_sem(struct rt_select *set, struct rt_sem *sem);
+
+/*
+ * Add a queue to the set. The queue is ready when it can be popped.
+ */
+bool rt_select_add_queue(struct rt_select *set, struct rt_queue *queue);
+
+bool rt_select_add_notify(struct rt_select *set, struct rt_notify *note);
+
+/*
+ * Block until a member is ready and return the object that was added to the
+ * set. The try and timed variants return NULL on failure.
+ */
+void *rt_select_wait(struct rt_select *set);
+
+void *rt_select_trywait(struct rt_select *set);
+
+void *rt_select_timedwait(struct rt_select *set, unsigned long ticks);
+
+struct rt_select_member
+{
+    struct rt_sem *sem;
+    void *object;
+};
+
+struct rt_select
+{
+    struct rt_sem sem;
+    struct rt_select_member *members;
+    size_t num_members, max_members;
+};
+
+#define RT_SELECT_STATIC(name, max)                                            \
+    static struct rt_select_member name##_members[(max)];                      \
+    static struct rt_select name = {                                           \
+        .sem = RT_SEM_INIT(name.sem, 0),                                       \
+        .members = name##_members,                                             \
+        .num_members = 0,                                                      \
+        .max_members = (max),                                                  \
+    }
+
+#endif /* RT_SELECT_H */
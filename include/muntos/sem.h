@@ -10,6 +10,7 @@
 #include <stddef.h>
 
 struct rt_sem;
+struct rt_select;
 
 void rt_sem_init(struct rt_sem *sem, int count);
 
@@ -27,6 +28,14 @@ bool rt_sem_trywait(struct rt_sem *sem);
 
 bool rt_sem_timedwait(struct rt_sem *sem, unsigned long ticks);
 
+/*
+ * Wait on a semaphore for whatever remains of a timeout of ticks that started
+ * at start_tick, for retrying an operation until an overall timeout expires.
+ * If the timeout has already expired, this only tries to take the semaphore.
+ */
+bool rt_sem_timedwait_since(struct rt_sem *sem, unsigned long start_tick,
+                            unsigned long ticks);
+
 void rt_sem_add_n(struct rt_sem *sem, int n);
 
 struct rt_sem
@@ -37,6 +46,7 @@ struct rt_sem
     int max_value;
     size_t num_waiters;
     rt_atomic_flag post_pending;
+    struct rt_select *select;
 };
 
 #define RT_SEM_INIT_MAX(name, count, max)                                      \
@@ -49,7 +59,7 @@ struct rt_sem
                 .syscall = RT_SYSCALL_SEM_POST,                                \
             },                                                                 \
         .value = count, .max_value = max, .num_waiters = 0,                    \
-        .post_pending = RT_ATOMIC_FLAG_INIT,                                   \
+        .post_pending = RT_ATOMIC_FLAG_INIT, .select = NULL,                   \
     }
 
 #define RT_SEM_INIT(name, count) RT_SEM_INIT_MAX(name, count, INT_MAX)
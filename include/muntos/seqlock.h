@@ -0,0 +1,63 @@
+#ifndef RT_SEQLOCK_H
+#define RT_SEQLOCK_H
+
+/*
+ * A sequence lock, which lets readers take consistent snapshots of data
+ * written by a single writer without ever blocking the writer or entering the
+ * kernel. The writer makes the sequence number odd while it writes and even
+ * again when it is done, and a reader retries if the sequence number was odd
+ * when it started or has changed since. Readers only load the sequence number,
+ * so any number of readers cost the writer nothing.
+ *
+ *     unsigned seq;
+ *     do
+ *     {
+ *         seq = rt_seqlock_read_begin(&lock);
+ *         snapshot = state;
+ *     } while (rt_seqlock_read_retry(&lock, seq));
+ *
+ * Readers may see the data while it is being written, so they must only use
+ * their copy after rt_seqlock_read_retry returns false. Concurrent writers
+ * must be serialized by other means, e.g., a mutex. A reader that preempts a
+ * writer keeps retrying until the writer finishes, so on a single core the
+ * writer should run at a priority at least as high as its readers, or from an
+ * interrupt.
+ */
+
+#include <muntos/atomic.h>
+
+#include <stdbool.h>
+
+struct rt_seqlock;
+
+void rt_seqlock_init(struct rt_seqlock *lock);
+
+/*
+ * Begin a read and return the sequence number to pass to
+ * rt_seqlock_read_retry.
+ */
+unsigned rt_seqlock_read_begin(const struct rt_seqlock *lock);
+
+/*
+ * Returns true if the data read since rt_seqlock_read_begin may be
+ * inconsistent and the read must be retried.
+ */
+bool rt_seqlock_read_retry(const struct rt_seqlock *lock, unsigned seq);
+
+void rt_seqlock_write_begin(struct rt_seqlock *lock);
+
+void rt_seqlock_write_end(struct rt_seqlock *lock);
+
+struct rt_seqlock
+{
+    rt_atomic_uint seq;
+};
+
+#define RT_SEQLOCK_INIT(name)                                                  \
+    {                                                                          \
+        .seq = 0                                                               \
+    }
+
+#define RT_SEQLOCK(name) struct rt_seqlock name = RT_SEQLOCK_INIT(name)
+
+#endif /* RT_SEQLOCK_H */
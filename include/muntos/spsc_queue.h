@@ -0,0 +1,79 @@
+#ifndef RT_SPSC_QUEUE_H
+#define RT_SPSC_QUEUE_H
+
+/*
+ * A bounded, single-producer, single-consumer, lock-free queue that supports
+ * blocking, timed, and non-blocking push, pop, and peek. At most one
+ * task/interrupt may push and at most one task/interrupt may pop or peek at a
+ * time. The producer and consumer each own one index, so each operation is a
+ * copy and a store-release of the owned index. A side that finds the queue
+ * empty or full sets a waiting flag and checks again before it blocks, and a
+ * push or pop only posts the other side's semaphore when that flag is set, so
+ * operations that don't block never post. The number of elements must be a
+ * power of two.
+ */
+
+#include <muntos/atomic.h>
+#include <muntos/cache.h>
+#include <muntos/sem.h>
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+struct rt_spsc_queue;
+
+void rt_spsc_queue_push(struct rt_spsc_queue *queue, const void *elem);
+
+void rt_spsc_queue_pop(struct rt_spsc_queue *queue, void *elem);
+
+void rt_spsc_queue_peek(struct rt_spsc_queue *queue, void *elem);
+
+bool rt_spsc_queue_trypush(struct rt_spsc_queue *queue, const void *elem);
+
+bool rt_spsc_queue_trypop(struct rt_spsc_queue *queue, void *elem);
+
+bool rt_spsc_queue_trypeek(struct rt_spsc_queue *queue, void *elem);
+
+bool rt_spsc_queue_timedpush(struct rt_spsc_queue *queue, const void *elem,
+                             unsigned long ticks);
+
+bool rt_spsc_queue_timedpop(struct rt_spsc_queue *queue, void *elem,
+                            unsigned long ticks);
+
+bool rt_spsc_queue_timedpeek(struct rt_spsc_queue *queue, void *elem,
+                             unsigned long ticks);
+
+struct rt_spsc_queue
+{
+    /* Producer-side fields. */
+    struct rt_sem push_sem RT_CACHE_ALIGNED;
+    rt_atomic_size_t enq;
+    rt_atomic_bool push_waiting;
+
+    /* Consumer-side fields. */
+    struct rt_sem pop_sem RT_CACHE_ALIGNED;
+    rt_atomic_size_t deq;
+    rt_atomic_bool pop_waiting;
+
+    void *data RT_CACHE_ALIGNED;
+    size_t mask, elem_size;
+};
+
+#define RT_SPSC_QUEUE_STATIC(name, type, num)                                  \
+    static_assert(((num) > 0) && (((num) & ((num)-1)) == 0),                   \
+                  "queue size must be a power of two");                        \
+    static type name##_elems[(num)];                                           \
+    static struct rt_spsc_queue name = {                                       \
+        .push_sem = RT_SEM_INIT_BINARY(name.push_sem, 0),                      \
+        .enq = 0,                                                              \
+        .push_waiting = false,                                                 \
+        .pop_sem = RT_SEM_INIT_BINARY(name.pop_sem, 0),                        \
+        .deq = 0,                                                              \
+        .pop_waiting = false,                                                  \
+        .data = name##_elems,                                                  \
+        .mask = (num)-1,                                                       \
+        .elem_size = sizeof(type),                                             \
+    }
+
+#endif /* RT_SPSC_QUEUE_H */
@@ -0,0 +1,130 @@
+#ifndef RT_STREAM_BUFFER_H
+#define RT_STREAM_BUFFER_H
+
+/*
+ * A bounded, single-writer, single-reader, lock-free byte stream. At most one
+ * task/interrupt may write and at most one task/interrupt may read at a time.
+ * Writes and reads transfer as many bytes as fit or are available, so a burst
+ * of bytes costs one copy rather than one per byte. A side only posts the
+ * other side's semaphore when that side is blocked, and a blocked reader is
+ * only woken once at least the trigger level of bytes is available. The size
+ * of the buffer must be a power of two.
+ */
+
+#include <muntos/atomic.h>
+#include <muntos/cache.h>
+#include <muntos/sem.h>
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+struct rt_stream_buffer;
+
+/*
+ * Write all len bytes, blocking until there is space for them.
+ */
+void rt_stream_buffer_write(struct rt_stream_buffer *sb, const void *data,
+                            size_t len);
+
+/*
+ * Write as many of len bytes as currently fit and return the number written.
+ */
+size_t rt_stream_buffer_trywrite(struct rt_stream_buffer *sb, const void *data,
+                                 size_t len);
+
+/*
+ * Write up to len bytes, blocking for at most ticks until there is space for
+ * them, and return the number written.
+ */
+size_t rt_stream_buffer_timedwrite(struct rt_stream_buffer *sb,
+                                   const void *data, size_t len,
+                                   unsigned long ticks);
+
+/*
+ * Block until at least the trigger level of bytes is available, then read up
+ * to len bytes and return the number read.
+ */
+size_t rt_stream_buffer_read(struct rt_stream_buffer *sb, void *data,
+                             size_t len);
+
+/*
+ * Read up to len bytes that are currently available, regardless of the trigger
+ * level, and return the number read.
+ */
+size_t rt_stream_buffer_tryread(struct rt_stream_buffer *sb, void *data,
+                                size_t len);
+
+/*
+ * Like rt_stream_buffer_read, but if the trigger level isn't reached within
+ * ticks, read whatever is available.
+ */
+size_t rt_stream_buffer_timedread(struct rt_stream_buffer *sb, void *data,
+                                  size_t len, unsigned long ticks);
+
+/*
+ * Set the number of bytes that must be available before a blocked reader is
+ * woken. The level is clamped to between 1 and the size of the buffer.
+ */
+void rt_stream_buffer_set_trigger(struct rt_stream_buffer *sb, size_t level);
+
+/*
+ * Get the number of bytes available to read.
+ */
+size_t rt_stream_buffer_available(const struct rt_stream_buffer *sb);
+
+/*
+ * Get a pointer to the largest contiguous free region of the buffer and return
+ * its size, so the writer can fill it in place. Only the writer may call this,
+ * and the bytes are not visible to the reader until they are passed to
+ * rt_stream_buffer_commit.
+ */
+size_t rt_stream_buffer_write_region(struct rt_stream_buffer *sb, void **data);
+
+void rt_stream_buffer_commit(struct rt_stream_buffer *sb, size_t len);
+
+/*
+ * Get a pointer to the largest contiguous readable region of the buffer and
+ * return its size, so the reader can use it in place. Only the reader may call
+ * this, and the bytes are not reused by the writer until they are passed to
+ * rt_stream_buffer_consume.
+ */
+size_t rt_stream_buffer_read_region(struct rt_stream_buffer *sb,
+                                    const void **data);
+
+void rt_stream_buffer_consume(struct rt_stream_buffer *sb, size_t len);
+
+struct rt_stream_buffer
+{
+    /* Writer-side fields. */
+    struct rt_sem write_sem RT_CACHE_ALIGNED;
+    rt_atomic_size_t head;
+    rt_atomic_bool write_waiting;
+
+    /* Reader-side fields. */
+    struct rt_sem read_sem RT_CACHE_ALIGNED;
+    rt_atomic_size_t tail;
+    rt_atomic_size_t trigger;
+    rt_atomic_bool read_waiting;
+
+    unsigned char *data RT_CACHE_ALIGNED;
+    size_t mask;
+};
+
+#define RT_STREAM_BUFFER_STATIC(name, size)                                    \
+    static_assert(((size) > 0) && (((size) & ((size)-1)) == 0),                \
+                  "stream buffer size must be a power of two");                \
+    static unsigned char name##_data[(size)];                                  \
+    static struct rt_stream_buffer name = {                                    \
+        .write_sem = RT_SEM_INIT_BINARY(name.write_sem, 0),                    \
+        .head = 0,                                                             \
+        .write_waiting = false,                                                \
+        .read_sem = RT_SEM_INIT_BINARY(name.read_sem, 0),                      \
+        .tail = 0,                                                             \
+        .trigger = 1,                                                          \
+        .read_waiting = false,                                                 \
+        .data = name##_data,                                                   \
+        .mask = (size)-1,                                                      \
+    }
+
+#endif /* RT_STREAM_BUFFER_H */
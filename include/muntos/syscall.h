@@ -1,8 +1,13 @@
 #ifndef RT_SYSCALL_H
 #define RT_SYSCALL_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 struct rt_task;
 
+struct rt_task_priority_change;
+
 enum rt_syscall
 {
     /* Processes a tick. */
@@ -22,8 +27,35 @@ enum rt_syscall
     /* Post a semaphore from a task or interrupt. */
     RT_SYSCALL_SEM_POST,
 
+    /* Wait on a condition variable from a task, and reacquire its mutex. */
+    RT_SYSCALL_COND_WAIT,
+    RT_SYSCALL_COND_TIMEDWAIT,
+
     /* Add a task to the ready list. */
     RT_SYSCALL_TASK_READY,
+
+    /* Wait on an event group from a task. */
+    RT_SYSCALL_EVENT_GROUP_WAIT,
+    RT_SYSCALL_EVENT_GROUP_TIMEDWAIT,
+
+    /* Wake event group waiters after setting bits from a task or interrupt. */
+    RT_SYSCALL_EVENT_GROUP_SET,
+
+    /* Start or stop a timer from a task or interrupt. */
+    RT_SYSCALL_TIMER,
+
+    /* Change the priorities of one or more tasks. */
+    RT_SYSCALL_TASK_SET_PRIORITY,
+
+    /* Suspend or resume a task from a task or interrupt. */
+    RT_SYSCALL_TASK_SUSPEND,
+
+    /* Wait for a notification to the current task. */
+    RT_SYSCALL_TASK_NOTIFY_WAIT,
+    RT_SYSCALL_TASK_NOTIFY_TIMEDWAIT,
+
+    /* Wake a task waiting for a notification, from a task or interrupt. */
+    RT_SYSCALL_TASK_NOTIFY,
 };
 
 union rt_syscall_args
@@ -51,6 +83,42 @@ union rt_syscall_args
         struct rt_sem *sem;
         int n;
     } sem_post;
+    struct
+    {
+        struct rt_sem *sem;
+        struct rt_mutex *mutex;
+        /* A timeout is in the task's wake_tick. */
+    } cond_wait;
+    struct
+    {
+        struct rt_event_group *group;
+        /* The mask to wait for, which is replaced by the bits that satisfied
+         * the wait. The flags are in the task's event_group_flags and a
+         * timeout is in its wake_tick. */
+        union
+        {
+            uint32_t mask;
+            uint32_t bits;
+        };
+    } event_group_wait;
+    struct
+    {
+        struct rt_event_group *group;
+    } event_group_set;
+    struct
+    {
+        struct rt_timer *timer;
+    } timer;
+    struct
+    {
+        /* Points to the caller's description of the change, which stays valid
+         * because the caller waits for the system call to be handled. */
+        const struct rt_task_priority_change *change;
+    } task_set_priority;
+    struct
+    {
+        unsigned long ticks;
+    } task_notify_wait;
 };
 
 struct rt_syscall_record
@@ -1,6 +1,7 @@
 #ifndef RT_TASK_H
 #define RT_TASK_H
 
+#include <muntos/atomic.h>
 #include <muntos/context.h>
 #include <muntos/cycle.h>
 #include <muntos/list.h>
@@ -19,6 +20,14 @@
 #error "To use task cycle counts, the cycle counter must be enabled."
 #endif
 
+/*
+ * Direct-to-task notifications (task_notify.h) store their state in each
+ * task, so they are only available when enabled.
+ */
+#ifndef RT_TASK_ENABLE_NOTIFY
+#define RT_TASK_ENABLE_NOTIFY 0
+#endif
+
 struct rt_task;
 
 /*
@@ -36,6 +45,50 @@ void rt_task_init_arg(struct rt_task *task, void (*fn)(uintptr_t),
                       uintptr_t arg, const char *name, unsigned priority,
                       void *stack, size_t stack_size);
 
+/*
+ * Change the priority of a task, repositioning it in the ready list or in the
+ * wait list it is blocked on. If this makes a ready task higher priority than
+ * the caller, it preempts the caller before this returns.
+ */
+void rt_task_set_priority(struct rt_task *task, unsigned priority);
+
+/*
+ * Change the priorities of several tasks at once, so that the scheduler runs
+ * once for all of them. tasks[i] is changed to priorities[i].
+ */
+void rt_task_set_priorities(struct rt_task *const *tasks,
+                            const unsigned *priorities, size_t num_tasks);
+
+/*
+ * Suspend a task, so that it doesn't run again until it is resumed. A task that
+ * is waiting or sleeping when it is suspended keeps waiting, but if its wait
+ * ends before it is resumed, it stays suspended until then. A task may suspend
+ * itself. Suspending and resuming can be done from tasks or interrupts, and if
+ * a task is suspended and resumed again before the system call is handled,
+ * only the last of these takes effect.
+ */
+void rt_task_suspend(struct rt_task *task);
+
+void rt_task_resume(struct rt_task *task);
+
+/*
+ * Suspend or resume several tasks at once, so that the scheduler runs once for
+ * all of them.
+ */
+void rt_task_suspend_group(struct rt_task *const *tasks, size_t num_tasks);
+
+void rt_task_resume_group(struct rt_task *const *tasks, size_t num_tasks);
+
+/*
+ * Set the preemption threshold of a task. Once the task is running, it can
+ * only be preempted by tasks with a higher priority than its threshold, until
+ * it next waits, sleeps, or exits. This lets a group of tasks run to
+ * completion with respect to each other while still being preempted by more
+ * urgent tasks. The threshold must be at least the task's priority. Must be
+ * called before rt_start().
+ */
+void rt_task_set_threshold(struct rt_task *task, unsigned threshold);
+
 /*
  * Yield the core to another task of the same priority. If the current task is
  * still the highest priority, it will continue executing.
@@ -80,6 +133,7 @@ enum rt_task_state
     RT_TASK_STATE_BLOCKED,
     RT_TASK_STATE_BLOCKED_TIMEOUT,
     RT_TASK_STATE_ASLEEP,
+    RT_TASK_STATE_SUSPENDED,
     RT_TASK_STATE_EXITED,
 };
 
@@ -95,10 +149,28 @@ struct rt_task
 #if RT_MPU_ENABLE
     struct rt_mpu_config mpu_config;
 #endif
+    /* The tick to wake at, or the timeout in ticks of a timed wait whose
+     * system call arguments have no room for it, until the wait is handled. */
     unsigned long wake_tick;
     struct rt_syscall_record record;
+    struct rt_task *suspend_next;
+    rt_atomic_bool suspend;
+    rt_atomic_flag suspend_pending;
+    bool suspended;
+    unsigned char event_group_flags;
+    /* The task's read-side critical section depth, which only the task
+     * changes, and which of the two grace period counts it is in, if it was
+     * switched out inside a critical section. */
+    unsigned char rcu_counted;
+    unsigned short rcu_nesting;
+#if RT_TASK_ENABLE_NOTIFY
+    rt_atomic_uint32_t notify_value;
+    rt_atomic_int notify_state;
+#endif
     const char *name;
     unsigned priority;
+    unsigned base_priority;
+    unsigned threshold;
     enum rt_task_state state;
 };
 
@@ -106,16 +178,22 @@ struct rt_task
     {                                                                          \
         .list = RT_LIST_INIT(name_.list),                                      \
         .sleep_list = RT_LIST_INIT(name_.sleep_list),                          \
-        .record.syscall = RT_SYSCALL_TASK_READY, .name = (name_str),           \
-        .priority = (priority_),                                               \
+        .record.syscall = RT_SYSCALL_TASK_READY,                               \
+        .suspend_next = NULL, .suspend = false,                                \
+        .suspend_pending = RT_ATOMIC_FLAG_INIT,                                \
+        .suspended = false, .rcu_counted = 0, .rcu_nesting = 0,                \
+        .name = (name_str),                                                    \
+        .priority = (priority_), .base_priority = (priority_),                 \
+        .threshold = (priority_),                                              \
     }
 
-#define RT_TASK(fn, stack_size, priority_)                                     \
+#define RT_TASK_THRESHOLD(fn, stack_size, priority_, threshold_)               \
     do                                                                         \
     {                                                                          \
         RT_STACK(fn##_task_stack, stack_size);                                 \
         static struct rt_task fn##_task =                                      \
             RT_TASK_INIT(fn##_task, #fn, priority_);                           \
+        fn##_task.threshold = (threshold_);                                    \
         fn##_task.ctx =                                                        \
             rt_context_create((fn), fn##_task_stack, sizeof fn##_task_stack);  \
         rt_mpu_config_init(&fn##_task.mpu_config);                             \
@@ -125,12 +203,13 @@ struct rt_task
         rt_syscall(&fn##_task.record);                                         \
     } while (0)
 
-#define RT_TASK_ARG(fn, arg, stack_size, priority_)                            \
+#define RT_TASK_ARG_THRESHOLD(fn, arg, stack_size, priority_, threshold_)      \
     do                                                                         \
     {                                                                          \
         RT_STACK(fn##_task_stack, stack_size);                                 \
         static struct rt_task fn##_task =                                      \
             RT_TASK_INIT(fn##_task, #fn "(" #arg ")", priority_);              \
+        fn##_task.threshold = (threshold_);                                    \
         fn##_task.ctx = rt_context_create_arg((fn), (arg), fn##_task_stack,    \
                                               sizeof fn##_task_stack);         \
         rt_mpu_config_init(&fn##_task.mpu_config);                             \
@@ -140,4 +219,10 @@ struct rt_task
         rt_syscall(&fn##_task.record);                                         \
     } while (0)
 
+#define RT_TASK(fn, stack_size, priority_)                                     \
+    RT_TASK_THRESHOLD(fn, stack_size, priority_, priority_)
+
+#define RT_TASK_ARG(fn, arg, stack_size, priority_)                            \
+    RT_TASK_ARG_THRESHOLD(fn, arg, stack_size, priority_, priority_)
+
 #endif /* RT_TASK_H */
@@ -0,0 +1,91 @@
+#ifndef RT_TASK_NOTIFY_H
+#define RT_TASK_NOTIFY_H
+
+/*
+ * Notifications sent directly to a task, stored in the task itself. These
+ * work like a struct rt_notify with exactly one receiver, but without a
+ * separate semaphore, and the receiver blocks on its own notification state
+ * rather than on a wait list. A notification is pending from when it is sent
+ * until the task receives it, and notifications sent while one is pending are
+ * combined into it. Notifications may be sent from tasks or interrupts, and
+ * the wait functions may only be called by a task for its own notifications.
+ */
+
+#include <muntos/task.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if !RT_TASK_ENABLE_NOTIFY
+#error "To use task notifications, RT_TASK_ENABLE_NOTIFY must be enabled."
+#endif
+
+/*
+ * Notify without changing the notification value.
+ */
+void rt_task_notify(struct rt_task *task);
+
+/*
+ * Notify and set the notification value unconditionally.
+ */
+void rt_task_notify_set(struct rt_task *task, uint32_t value);
+
+/*
+ * Notify and |= the notification value.
+ */
+void rt_task_notify_or(struct rt_task *task, uint32_t value);
+
+/*
+ * Notify and += the notification value.
+ */
+void rt_task_notify_add(struct rt_task *task, uint32_t value);
+
+/*
+ * Notify and increment the notification value.
+ */
+void rt_task_notify_increment(struct rt_task *task);
+
+/*
+ * Block until the current task is notified, and return the notification value.
+ */
+uint32_t rt_task_notify_wait(void);
+
+/*
+ * rt_task_notify_wait and &= ~clear the notification value. The returned value
+ * is before clearing.
+ */
+uint32_t rt_task_notify_wait_clear(uint32_t clear);
+
+/*
+ * Get the notification value if a notification is pending. Returns false if
+ * there is no notification pending.
+ */
+bool rt_task_notify_trywait(uint32_t *value);
+
+bool rt_task_notify_trywait_clear(uint32_t clear, uint32_t *value);
+
+/*
+ * Wait for a notification until a timeout expires and get the value if a
+ * notification occurs. Returns false if there is no notification before the
+ * timeout expires.
+ */
+bool rt_task_notify_timedwait(uint32_t *value, unsigned long ticks);
+
+bool rt_task_notify_timedwait_clear(uint32_t clear, uint32_t *value,
+                                    unsigned long ticks);
+
+/*
+ * A task moves from none to waiting when it starts to wait, and the kernel
+ * moves it from waiting to blocked if it blocks the task. A notifier that
+ * replaces blocked with pending owns the task's system call record until the
+ * task is woken, and uses it to wake the task.
+ */
+enum rt_task_notify_state
+{
+    RT_TASK_NOTIFY_NONE,
+    RT_TASK_NOTIFY_PENDING,
+    RT_TASK_NOTIFY_WAITING,
+    RT_TASK_NOTIFY_BLOCKED,
+};
+
+#endif /* RT_TASK_NOTIFY_H */
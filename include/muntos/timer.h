@@ -0,0 +1,98 @@
+#ifndef RT_TIMER_H
+#define RT_TIMER_H
+
+/*
+ * Software timers that call a function once after a delay, or periodically,
+ * without a task per timer. Active timers are kept in a list ordered by
+ * expiry and processed along with each tick, and their callbacks are run in
+ * order of expiry by the timer daemon task, at whatever priority that task is
+ * created with. Timers can be started, stopped, and reset from tasks or
+ * interrupts. Each timer has its own system call record, so if a timer is
+ * commanded again before an earlier command has been handled, only the latest
+ * command takes effect. Commands to one timer must not be issued concurrently
+ * from different tasks/interrupts.
+ */
+
+#include <muntos/atomic.h>
+#include <muntos/list.h>
+#include <muntos/syscall.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct rt_timer;
+
+void rt_timer_init(struct rt_timer *timer, void (*fn)(uintptr_t),
+                   uintptr_t arg);
+
+/*
+ * Start the timer so that it expires after ticks, and then every period ticks
+ * if period is non-zero. Starting an active timer restarts it.
+ */
+void rt_timer_start(struct rt_timer *timer, unsigned long ticks,
+                    unsigned long period);
+
+/*
+ * Restart the timer with the delay and period it was last started with.
+ */
+void rt_timer_reset(struct rt_timer *timer);
+
+/*
+ * Stop the timer. A callback for an expiry that has already occurred may
+ * still run.
+ */
+void rt_timer_stop(struct rt_timer *timer);
+
+bool rt_timer_is_active(const struct rt_timer *timer);
+
+/*
+ * The task function of the timer daemon, which runs the callbacks of expired
+ * timers. Create one task with this function, at the priority that timer
+ * callbacks should run at. If a periodic timer expires again before its
+ * callback has run, the callback only runs once for both expiries.
+ */
+void rt_timer_daemon(void);
+
+enum rt_timer_command
+{
+    RT_TIMER_START,
+    RT_TIMER_STOP,
+};
+
+struct rt_timer
+{
+    struct rt_list list;
+    struct rt_timer *next_expired;
+    void (*fn)(uintptr_t);
+    uintptr_t arg;
+    /* Set by the commanding task/interrupt and read when the system call
+     * handles its start command or a periodic expiry, possibly while a new
+     * start is setting them. */
+    rt_atomic_ulong ticks, period;
+    unsigned long expiry;
+    rt_atomic_uint command;
+    rt_atomic_bool active;
+    rt_atomic_flag expired;
+    struct rt_syscall_record record;
+    rt_atomic_flag command_pending;
+};
+
+#define RT_TIMER_INIT(name, fn_, arg_)                                         \
+    {                                                                          \
+        .list = RT_LIST_INIT(name.list), .next_expired = NULL, .fn = (fn_),    \
+        .arg = (arg_), .ticks = 0, .period = 0, .expiry = 0,                   \
+        .command = RT_TIMER_STOP, .active = false,                             \
+        .expired = RT_ATOMIC_FLAG_INIT,                                        \
+        .record =                                                              \
+            {                                                                  \
+                .next = NULL,                                                  \
+                .args.timer.timer = &name,                                     \
+                .syscall = RT_SYSCALL_TIMER,                                   \
+            },                                                                 \
+        .command_pending = RT_ATOMIC_FLAG_INIT,                                \
+    }
+
+#define RT_TIMER(name, fn, arg)                                                \
+    struct rt_timer name = RT_TIMER_INIT(name, fn, arg)
+
+#endif /* RT_TIMER_H */
@@ -0,0 +1,68 @@
+#ifndef RT_WORKQUEUE_H
+#define RT_WORKQUEUE_H
+
+/*
+ * A work queue defers functions to be run by one or more worker tasks, so that
+ * interrupts and tasks can hand off work without a dedicated task per source.
+ * Work items are intrusive, so the caller owns their storage and can embed
+ * them in a larger structure, and submitting one is lock-free and safe from
+ * interrupts. Submitting an item that is already pending has no effect. Each
+ * worker takes all pending items at once and runs them in order of
+ * submission. An item may be submitted again once its function has started.
+ */
+
+#include <muntos/atomic.h>
+#include <muntos/sem.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct rt_work;
+
+struct rt_workqueue;
+
+void rt_work_init(struct rt_work *work, void (*fn)(struct rt_work *));
+
+void rt_workqueue_init(struct rt_workqueue *wq);
+
+/*
+ * Submit work to be run by a worker of wq. Returns false if work was already
+ * pending, in which case it will only run once.
+ */
+bool rt_workqueue_submit(struct rt_workqueue *wq, struct rt_work *work);
+
+/*
+ * The task function of a worker. arg is a pointer to the struct
+ * rt_workqueue, e.g., RT_TASK_ARG(rt_workqueue_worker, (uintptr_t)&wq, ...).
+ * Any number of workers may serve a work queue, at any priorities.
+ */
+void rt_workqueue_worker(uintptr_t arg);
+
+struct rt_work
+{
+    struct rt_work *next;
+    void (*fn)(struct rt_work *);
+    rt_atomic_flag pending;
+};
+
+#define RT_WORK_INIT(name, fn_)                                                \
+    {                                                                          \
+        .next = NULL, .fn = (fn_), .pending = RT_ATOMIC_FLAG_INIT,             \
+    }
+
+#define RT_WORK(name, fn) struct rt_work name = RT_WORK_INIT(name, fn)
+
+struct rt_workqueue
+{
+    struct rt_work *_Atomic head;
+    struct rt_sem sem;
+};
+
+#define RT_WORKQUEUE_INIT(name)                                                \
+    {                                                                          \
+        .head = NULL, .sem = RT_SEM_INIT_BINARY(name.sem, 0),                  \
+    }
+
+#define RT_WORKQUEUE(name) struct rt_workqueue name = RT_WORKQUEUE_INIT(name)
+
+#endif /* RT_WORKQUEUE_H */
@@ -3,36 +3,41 @@
 #include <muntos/log.h>
 #include <muntos/task.h>
 
+#include <limits.h>
+
+#define GEN_BIT (1U << (sizeof(unsigned) * CHAR_BIT - 1))
+
 void rt_barrier_init(struct rt_barrier *barrier, int count)
 {
-    barrier->tasks = 0;
-    barrier->count = count;
-    rt_sem_init(&barrier->sem, count);
-    rt_mutex_init(&barrier->mutex);
-    rt_cond_init(&barrier->cond);
+    rt_atomic_store_explicit(&barrier->state, 0, memory_order_relaxed);
+    barrier->count = (unsigned)count;
+    rt_sem_init(&barrier->sems[0], 0);
+    rt_sem_init(&barrier->sems[1], 0);
 }
 
 bool rt_barrier_wait(struct rt_barrier *barrier)
 {
-    rt_sem_wait(&barrier->sem);
+    const unsigned state =
+        rt_atomic_fetch_add_explicit(&barrier->state, 1, memory_order_acq_rel);
+    struct rt_sem *const sem = &barrier->sems[(state & GEN_BIT) ? 1 : 0];
 
-    rt_mutex_lock(&barrier->mutex);
-    ++barrier->tasks;
-    if (barrier->tasks == barrier->count)
-    {
-        rt_cond_broadcast(&barrier->cond);
-    }
-    else
+    if (((state & ~GEN_BIT) + 1) < barrier->count)
     {
-        rt_cond_wait(&barrier->cond, &barrier->mutex);
+        rt_logf("%s barrier wait, %u arrived\n", rt_task_name(),
+                (state & ~GEN_BIT) + 1);
+        rt_sem_wait(sem);
+        return false;
     }
-    --barrier->tasks;
-    const bool complete = barrier->tasks == 0;
-    if (complete)
+
+    /* This is the last arrival, so reset the count and flip the generation
+     * before releasing the others, so that their next arrivals count towards
+     * the next phase. */
+    rt_atomic_fetch_add_explicit(&barrier->state, GEN_BIT - barrier->count,
+                                 memory_order_release);
+    rt_logf("%s barrier complete\n", rt_task_name());
+    if (barrier->count > 1)
     {
-        rt_sem_post_n(&barrier->sem, barrier->count);
+        rt_sem_post_n(sem, (int)barrier->count - 1);
     }
-    rt_mutex_unlock(&barrier->mutex);
-
-    return complete;
+    return true;
 }
@@ -0,0 +1,70 @@
+#include <muntos/basic.h>
+
+#include <muntos/log.h>
+#include <muntos/stack.h>
+#include <muntos/task.h>
+
+void rt_basic_task_activate(struct rt_basic_group *group,
+                            struct rt_basic_task *task)
+{
+    rt_atomic_fetch_add_explicit(&task->activations, 1, memory_order_release);
+    rt_sem_post(&group->sem);
+}
+
+/*
+ * Claim an activation of the highest priority pending basic task.
+ */
+static struct rt_basic_task *next_task(const struct rt_basic_group *group)
+{
+    struct rt_basic_task *next = NULL;
+    for (size_t i = 0; i < group->num_tasks; ++i)
+    {
+        struct rt_basic_task *const task = group->tasks[i];
+        if ((rt_atomic_load_explicit(&task->activations,
+                                     memory_order_relaxed) > 0) &&
+            ((next == NULL) || (task->priority > next->priority)))
+        {
+            next = task;
+        }
+    }
+    if (next != NULL)
+    {
+        rt_atomic_fetch_sub_explicit(&next->activations, 1,
+                                     memory_order_acquire);
+    }
+    return next;
+}
+
+void rt_basic_group_run(uintptr_t arg)
+{
+    struct rt_basic_group *const group = (struct rt_basic_group *)arg;
+    for (;;)
+    {
+        /* Each activation posts the group's semaphore, so activations after
+         * the last check will be seen after this wait. */
+        rt_sem_wait(&group->sem);
+        for (;;)
+        {
+            struct rt_basic_task *const task = next_task(group);
+            if (task == NULL)
+            {
+                break;
+            }
+            rt_logf("%s running basic task %s\n", rt_task_name(), task->name);
+            task->fn();
+        }
+    }
+}
+
+size_t rt_basic_group_stack_size(const struct rt_basic_group *group)
+{
+    size_t max_stack_size = 0;
+    for (size_t i = 0; i < group->num_tasks; ++i)
+    {
+        if (group->tasks[i]->stack_size > max_stack_size)
+        {
+            max_stack_size = group->tasks[i]->stack_size;
+        }
+    }
+    return RT_STACK_MIN + max_stack_size;
+}
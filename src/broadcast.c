@@ -0,0 +1,184 @@
+#include <muntos/broadcast.h>
+
+#include <muntos/container.h>
+#include <muntos/log.h>
+#include <muntos/task.h>
+#include <muntos/tick.h>
+
+#include <string.h>
+
+static void *elem_ptr(const struct rt_broadcast *bc, size_t seq)
+{
+    unsigned char *const p = bc->data;
+    return &p[bc->elem_size * (seq % bc->num_elems)];
+}
+
+void rt_broadcast_subscribe(struct rt_broadcast *bc,
+                            struct rt_broadcast_sub *sub)
+{
+    rt_mutex_lock(&bc->mutex);
+    sub->bc = bc;
+    sub->cursor = bc->head;
+    sub->lost = 0;
+    rt_list_push_back(&bc->subs, &sub->list);
+    rt_mutex_unlock(&bc->mutex);
+}
+
+void rt_broadcast_unsubscribe(struct rt_broadcast_sub *sub)
+{
+    struct rt_broadcast *const bc = sub->bc;
+    rt_mutex_lock(&bc->mutex);
+    rt_list_remove(&sub->list);
+    /* The departing subscriber may have been the one holding back publishers
+     * under RT_BROADCAST_BLOCK. */
+    rt_cond_broadcast(&bc->space_cond);
+    rt_mutex_unlock(&bc->mutex);
+}
+
+/*
+ * Returns true if publishing now would overwrite a message that a subscriber
+ * has not read yet and the channel's policy is to wait for it.
+ */
+static bool must_wait(const struct rt_broadcast *bc)
+{
+    if (bc->policy != RT_BROADCAST_BLOCK)
+    {
+        return false;
+    }
+    const struct rt_list *node;
+    rt_list_for_each(node, &bc->subs)
+    {
+        const struct rt_broadcast_sub *const sub =
+            rt_container_of(node, const struct rt_broadcast_sub, list);
+        if ((bc->head - sub->cursor) >= bc->num_elems)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void publish(struct rt_broadcast *bc, const void *msg)
+{
+    memcpy(elem_ptr(bc, bc->head), msg, bc->elem_size);
+    rt_logf("%s broadcast publish: %zu\n", rt_task_name(), bc->head);
+    ++bc->head;
+    rt_cond_broadcast(&bc->data_cond);
+    rt_mutex_unlock(&bc->mutex);
+}
+
+void rt_broadcast_publish(struct rt_broadcast *bc, const void *msg)
+{
+    rt_mutex_lock(&bc->mutex);
+    while (must_wait(bc))
+    {
+        rt_cond_wait(&bc->space_cond, &bc->mutex);
+    }
+    publish(bc, msg);
+}
+
+bool rt_broadcast_trypublish(struct rt_broadcast *bc, const void *msg)
+{
+    rt_mutex_lock(&bc->mutex);
+    if (must_wait(bc))
+    {
+        rt_mutex_unlock(&bc->mutex);
+        return false;
+    }
+    publish(bc, msg);
+    return true;
+}
+
+bool rt_broadcast_timedpublish(struct rt_broadcast *bc, const void *msg,
+                               unsigned long ticks)
+{
+    const unsigned long start_tick = rt_tick();
+    rt_mutex_lock(&bc->mutex);
+    while (must_wait(bc))
+    {
+        if (!rt_cond_timedwait_since(&bc->space_cond, &bc->mutex, start_tick,
+                                     ticks))
+        {
+            return false;
+        }
+    }
+    publish(bc, msg);
+    return true;
+}
+
+/*
+ * Copy out the subscriber's next message if there is one. The mutex must be
+ * held, and is released if a message was read.
+ */
+static bool tryread(struct rt_broadcast_sub *sub, void *msg)
+{
+    struct rt_broadcast *const bc = sub->bc;
+    if (sub->cursor == bc->head)
+    {
+        return false;
+    }
+    if ((bc->head - sub->cursor) > bc->num_elems)
+    {
+        /* Messages were overwritten before this subscriber read them, so skip
+         * to the oldest one still in the ring. */
+        const size_t oldest = bc->head - bc->num_elems;
+        sub->lost += oldest - sub->cursor;
+        rt_logf("%s broadcast lost %zu\n", rt_task_name(),
+                oldest - sub->cursor);
+        sub->cursor = oldest;
+    }
+    memcpy(msg, elem_ptr(bc, sub->cursor), bc->elem_size);
+    rt_logf("%s broadcast read: %zu\n", rt_task_name(), sub->cursor);
+    ++sub->cursor;
+    if (bc->policy == RT_BROADCAST_BLOCK)
+    {
+        rt_cond_broadcast(&bc->space_cond);
+    }
+    rt_mutex_unlock(&bc->mutex);
+    return true;
+}
+
+void rt_broadcast_read(struct rt_broadcast_sub *sub, void *msg)
+{
+    struct rt_broadcast *const bc = sub->bc;
+    rt_mutex_lock(&bc->mutex);
+    while (!tryread(sub, msg))
+    {
+        rt_cond_wait(&bc->data_cond, &bc->mutex);
+    }
+}
+
+bool rt_broadcast_tryread(struct rt_broadcast_sub *sub, void *msg)
+{
+    struct rt_broadcast *const bc = sub->bc;
+    rt_mutex_lock(&bc->mutex);
+    if (!tryread(sub, msg))
+    {
+        rt_mutex_unlock(&bc->mutex);
+        return false;
+    }
+    return true;
+}
+
+bool rt_broadcast_timedread(struct rt_broadcast_sub *sub, void *msg,
+                            unsigned long ticks)
+{
+    struct rt_broadcast *const bc = sub->bc;
+    const unsigned long start_tick = rt_tick();
+    rt_mutex_lock(&bc->mutex);
+    while (!tryread(sub, msg))
+    {
+        if (!rt_cond_timedwait_since(&bc->data_cond, &bc->mutex, start_tick,
+                                     ticks))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+unsigned long rt_broadcast_lost(const struct rt_broadcast_sub *sub)
+{
+    /* Only the subscriber's own reads update this count. */
+    return sub->lost;
+}
@@ -36,20 +36,27 @@ void rt_cond_wait(struct rt_cond *cond, struct rt_mutex *mutex)
 
     rt_logf("%s cond wait, waiting\n", rt_task_name());
 
+    /* When signaled, the system call handler moves this task to the mutex's
+     * wait list if the mutex is held, so the mutex is held when the system
+     * call returns. If the mutex was free, it clears the mutex argument
+     * instead, and the task locks the mutex itself. */
     struct rt_syscall_record *const wait_record = &rt_task_self()->record;
-    wait_record->args.sem_wait.sem = &cond->sem;
-    wait_record->syscall = RT_SYSCALL_SEM_WAIT;
+    wait_record->args.cond_wait.sem = &cond->sem;
+    wait_record->args.cond_wait.mutex = mutex;
+    wait_record->syscall = RT_SYSCALL_COND_WAIT;
     rt_syscall(wait_record);
 
     rt_logf("%s cond wait, awoken\n", rt_task_name());
 
-    rt_mutex_lock(mutex);
+    if (wait_record->args.cond_wait.mutex == NULL)
+    {
+        rt_mutex_lock(mutex);
+    }
 }
 
 bool rt_cond_timedwait(struct rt_cond *cond, struct rt_mutex *mutex,
                        unsigned long ticks)
 {
-    const unsigned long start_tick = rt_tick();
     const int value =
         rt_atomic_fetch_sub_explicit(&cond->sem.value, 1, memory_order_relaxed);
 
@@ -62,26 +69,35 @@ bool rt_cond_timedwait(struct rt_cond *cond, struct rt_mutex *mutex,
         return false;
     }
 
-    struct rt_syscall_record *const record = &rt_task_self()->record;
-    record->args.sem_timedwait.sem = &cond->sem;
-    record->args.sem_timedwait.ticks = ticks;
-    record->syscall = RT_SYSCALL_SEM_TIMEDWAIT;
+    /* The timeout only applies to waiting for a signal. Once signaled, the
+     * task waits for the mutex without a timeout. */
+    struct rt_task *const task = rt_task_self();
+    struct rt_syscall_record *const record = &task->record;
+    record->args.cond_wait.sem = &cond->sem;
+    record->args.cond_wait.mutex = mutex;
+    task->wake_tick = ticks;
+    record->syscall = RT_SYSCALL_COND_TIMEDWAIT;
     rt_syscall(record);
 
-    if (record->args.sem_timedwait.sem == NULL)
+    if (record->args.cond_wait.sem == NULL)
     {
         return false;
     }
+    if (record->args.cond_wait.mutex == NULL)
+    {
+        rt_mutex_lock(mutex);
+    }
+    return true;
+}
 
+bool rt_cond_timedwait_since(struct rt_cond *cond, struct rt_mutex *mutex,
+                             unsigned long start_tick, unsigned long ticks)
+{
     const unsigned long ticks_waited = rt_tick() - start_tick;
     if (ticks_waited >= ticks)
     {
-        ticks = 0;
-    }
-    else
-    {
-        ticks -= ticks_waited;
+        rt_mutex_unlock(mutex);
+        return false;
     }
-
-    return rt_mutex_timedlock(mutex, ticks);
+    return rt_cond_timedwait(cond, mutex, ticks - ticks_waited);
 }
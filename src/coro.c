@@ -0,0 +1,113 @@
+#include <muntos/coro.h>
+
+#include <muntos/container.h>
+#include <muntos/log.h>
+#include <muntos/task.h>
+
+#include <limits.h>
+
+void rt_coro_init(struct rt_coro *coro, void (*fn)(struct rt_coro *),
+                  const char *name)
+{
+    rt_list_init(&coro->list);
+    coro->fn = fn;
+    coro->name = name;
+    coro->sleep_start = 0;
+    coro->sleep_ticks = 0;
+    coro->line = 0;
+    coro->sleeping = false;
+    coro->yielded = false;
+}
+
+void rt_coro_host_add(struct rt_coro_host *host, struct rt_coro *coro)
+{
+    rt_list_push_back(&host->coros, &coro->list);
+}
+
+bool rt_coro_host_add_sem(struct rt_coro_host *host, struct rt_sem *sem)
+{
+    return rt_select_add_sem(&host->set, sem);
+}
+
+bool rt_coro_host_add_queue_pop(struct rt_coro_host *host,
+                                struct rt_queue *queue)
+{
+    return rt_select_add_sem(&host->set, &queue->pop_sem);
+}
+
+bool rt_coro_host_add_queue_push(struct rt_coro_host *host,
+                                 struct rt_queue *queue)
+{
+    return rt_select_add_sem(&host->set, &queue->push_sem);
+}
+
+bool rt_coro_woken(struct rt_coro *coro)
+{
+    coro->sleeping = (rt_tick() - coro->sleep_start) < coro->sleep_ticks;
+    return !coro->sleeping;
+}
+
+void rt_coro_host_run(uintptr_t arg)
+{
+    struct rt_coro_host *const host = (struct rt_coro_host *)arg;
+    for (;;)
+    {
+        /* The host's semaphore is posted by every post to a watched object.
+         * All coroutines are about to check their wait points, so any posts
+         * so far will be seen, and a post after this will wake the host
+         * again. */
+        while (rt_sem_trywait(&host->set.sem))
+        {
+        }
+
+        bool yielded = false;
+        unsigned long sleep_ticks = ULONG_MAX;
+        struct rt_list *node = rt_list_front(&host->coros);
+        while (node != &host->coros)
+        {
+            struct rt_coro *const coro =
+                rt_container_of(node, struct rt_coro, list);
+            /* The coroutine may remove itself, so move on first. */
+            node = node->next;
+
+            coro->sleeping = false;
+            coro->yielded = false;
+            coro->fn(coro);
+
+            if (coro->line == RT_CORO_DONE)
+            {
+                rt_logf("%s coroutine %s done\n", rt_task_name(), coro->name);
+                rt_list_remove(&coro->list);
+            }
+            else if (coro->yielded)
+            {
+                yielded = true;
+            }
+            else if (coro->sleeping)
+            {
+                const unsigned long elapsed = rt_tick() - coro->sleep_start;
+                const unsigned long remaining =
+                    (elapsed < coro->sleep_ticks)
+                        ? (coro->sleep_ticks - elapsed)
+                        : 0;
+                if (remaining < sleep_ticks)
+                {
+                    sleep_ticks = remaining;
+                }
+            }
+        }
+
+        if (yielded || (sleep_ticks == 0))
+        {
+            continue;
+        }
+        if (sleep_ticks == ULONG_MAX)
+        {
+            rt_sem_wait(&host->set.sem);
+        }
+        else
+        {
+            (void)rt_sem_timedwait(&host->set.sem, sleep_ticks);
+        }
+    }
+}
@@ -0,0 +1,138 @@
+#include <muntos/event_group.h>
+
+#include <muntos/interrupt.h>
+#include <muntos/log.h>
+#include <muntos/sched.h>
+#include <muntos/task.h>
+
+void rt_event_group_init(struct rt_event_group *group, uint32_t bits)
+{
+    rt_atomic_store_explicit(&group->bits, bits, memory_order_relaxed);
+    rt_list_init(&group->wait_list);
+    rt_atomic_store_explicit(&group->num_waiters, 0, memory_order_relaxed);
+    group->set_record.args.event_group_set.group = group;
+    group->set_record.syscall = RT_SYSCALL_EVENT_GROUP_SET;
+    rt_atomic_flag_clear_explicit(&group->set_pending, memory_order_release);
+}
+
+uint32_t rt_event_group_set(struct rt_event_group *group, uint32_t bits)
+{
+    /* The system call handler registers a waiter before checking the bits, and
+     * this sets the bits before checking for waiters, so either the handler
+     * sees these bits or this sees the waiter. */
+    const uint32_t old_bits = rt_atomic_fetch_or(&group->bits, bits);
+    if (rt_atomic_load(&group->num_waiters) == 0)
+    {
+        return old_bits;
+    }
+
+    rt_logf("%s event group set %08lx\n", rt_task_name(),
+            (unsigned long)bits);
+
+    if (rt_interrupt_is_active() || rt_sched_is_locked())
+    {
+        /* If the event group's set record is already pending, the system call
+         * will evaluate the waiters against these bits as well, so there is
+         * no need to use it again. */
+        if (!rt_atomic_flag_test_and_set_explicit(&group->set_pending,
+                                                  memory_order_acquire))
+        {
+            rt_syscall(&group->set_record);
+        }
+    }
+    else
+    {
+        struct rt_syscall_record *const set_record = &rt_task_self()->record;
+        set_record->args.event_group_set.group = group;
+        set_record->syscall = RT_SYSCALL_EVENT_GROUP_SET;
+        rt_syscall(set_record);
+    }
+    return old_bits;
+}
+
+uint32_t rt_event_group_clear(struct rt_event_group *group, uint32_t bits)
+{
+    return rt_atomic_fetch_and_explicit(&group->bits, ~bits,
+                                        memory_order_relaxed);
+}
+
+uint32_t rt_event_group_get(const struct rt_event_group *group)
+{
+    return rt_atomic_load_explicit(&group->bits, memory_order_relaxed);
+}
+
+bool rt_event_group_trywait(struct rt_event_group *group, uint32_t mask,
+                            unsigned flags, uint32_t *bits)
+{
+    uint32_t value =
+        rt_atomic_load_explicit(&group->bits, memory_order_acquire);
+    for (;;)
+    {
+        if (!rt_event_group_satisfied(value, mask, flags))
+        {
+            return false;
+        }
+        if (((flags & RT_EVENT_GROUP_CLEAR) == 0) ||
+            rt_atomic_compare_exchange_weak_explicit(
+                &group->bits, &value, value & ~mask, memory_order_acquire,
+                memory_order_acquire))
+        {
+            *bits = value;
+            return true;
+        }
+    }
+}
+
+uint32_t rt_event_group_wait(struct rt_event_group *group, uint32_t mask,
+                             unsigned flags)
+{
+    uint32_t bits;
+    if (rt_event_group_trywait(group, mask, flags, &bits))
+    {
+        return bits;
+    }
+
+    rt_logf("%s event group wait %08lx\n", rt_task_name(),
+            (unsigned long)mask);
+
+    struct rt_syscall_record *const wait_record = &rt_task_self()->record;
+    wait_record->args.event_group_wait.group = group;
+    wait_record->args.event_group_wait.mask = mask;
+    rt_task_self()->event_group_flags = (unsigned char)flags;
+    wait_record->syscall = RT_SYSCALL_EVENT_GROUP_WAIT;
+    rt_syscall(wait_record);
+
+    return wait_record->args.event_group_wait.bits;
+}
+
+bool rt_event_group_timedwait(struct rt_event_group *group, uint32_t mask,
+                              unsigned flags, uint32_t *bits,
+                              unsigned long ticks)
+{
+    if (rt_event_group_trywait(group, mask, flags, bits))
+    {
+        return true;
+    }
+
+    if (ticks == 0)
+    {
+        return false;
+    }
+
+    struct rt_task *const task = rt_task_self();
+    struct rt_syscall_record *const wait_record = &task->record;
+    wait_record->args.event_group_wait.group = group;
+    wait_record->args.event_group_wait.mask = mask;
+    task->event_group_flags = (unsigned char)flags;
+    task->wake_tick = ticks;
+    wait_record->syscall = RT_SYSCALL_EVENT_GROUP_TIMEDWAIT;
+    rt_syscall(wait_record);
+
+    /* The system call handler signals a timeout by clearing the group. */
+    if (wait_record->args.event_group_wait.group == NULL)
+    {
+        return false;
+    }
+    *bits = wait_record->args.event_group_wait.bits;
+    return true;
+}
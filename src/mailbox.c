@@ -0,0 +1,91 @@
+#include <muntos/mailbox.h>
+
+#include "waiter.h"
+
+#include <muntos/log.h>
+#include <muntos/tick.h>
+
+#include <string.h>
+
+static void *elem_ptr(const struct rt_mailbox *mailbox, unsigned index)
+{
+    unsigned char *const p = mailbox->data;
+    return &p[mailbox->elem_size * index];
+}
+
+void rt_mailbox_write(struct rt_mailbox *mailbox, const void *elem)
+{
+    memcpy(elem_ptr(mailbox, mailbox->write_index), elem,
+           mailbox->elem_size);
+    /* Release the new value to the reader, and acquire the buffer being
+     * taken back, which the reader may have just finished reading. */
+    const unsigned prev = rt_atomic_exchange_explicit(
+        &mailbox->latest,
+        (unsigned char)(mailbox->write_index | RT_MAILBOX_NEW),
+        memory_order_acq_rel);
+    mailbox->write_index = (unsigned char)(prev & RT_MAILBOX_INDEX_MASK);
+    rt_logf("mailbox write\n");
+    rt_waiter_wake(&mailbox->waiting, &mailbox->sem);
+}
+
+/*
+ * Take the latest buffer if it holds a new value. Returns true if it did.
+ */
+static bool take_latest(struct rt_mailbox *mailbox)
+{
+    if ((rt_atomic_load_explicit(&mailbox->latest, memory_order_relaxed) &
+         RT_MAILBOX_NEW) == 0)
+    {
+        return false;
+    }
+    /* Only the writer sets the new flag, so the latest buffer is still new
+     * here, though the writer may have replaced it with a newer one. */
+    const unsigned prev = rt_atomic_exchange_explicit(
+        &mailbox->latest, mailbox->read_index, memory_order_acq_rel);
+    mailbox->read_index = (unsigned char)(prev & RT_MAILBOX_INDEX_MASK);
+    return true;
+}
+
+bool rt_mailbox_read(struct rt_mailbox *mailbox, void *elem)
+{
+    const bool new_value = take_latest(mailbox);
+    memcpy(elem, elem_ptr(mailbox, mailbox->read_index), mailbox->elem_size);
+    return new_value;
+}
+
+bool rt_mailbox_tryread(struct rt_mailbox *mailbox, void *elem)
+{
+    if (!take_latest(mailbox))
+    {
+        return false;
+    }
+    memcpy(elem, elem_ptr(mailbox, mailbox->read_index), mailbox->elem_size);
+    return true;
+}
+
+void rt_mailbox_wait(struct rt_mailbox *mailbox, void *elem)
+{
+    /* The semaphore may have a post left from a write that was already read,
+     * so check again after each wake. */
+    bool announced = false;
+    while (!rt_mailbox_tryread(mailbox, elem))
+    {
+        rt_waiter_wait(&mailbox->waiting, &mailbox->sem, &announced);
+    }
+    rt_waiter_done(&mailbox->waiting, announced);
+}
+
+bool rt_mailbox_timedwait(struct rt_mailbox *mailbox, void *elem,
+                          unsigned long ticks)
+{
+    const unsigned long start_tick = rt_tick();
+    bool announced = false;
+    bool ok = true;
+    while (ok && !rt_mailbox_tryread(mailbox, elem))
+    {
+        ok = rt_waiter_timedwait(&mailbox->waiting, &mailbox->sem, &announced,
+                                 start_tick, ticks);
+    }
+    rt_waiter_done(&mailbox->waiting, announced);
+    return ok;
+}
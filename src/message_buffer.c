@@ -0,0 +1,194 @@
+#include <muntos/message_buffer.h>
+
+#include <muntos/log.h>
+#include <muntos/tick.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#define HEADER_SIZE sizeof(size_t)
+
+/* A length that marks the rest of the arena as unused, so that the next
+ * message starts at the beginning of the arena. */
+#define WRAP_LEN SIZE_MAX
+
+static size_t arena_size(const struct rt_message_buffer *mb)
+{
+    return mb->mask + 1;
+}
+
+/*
+ * The space taken by a message of length len, including its header and
+ * padding.
+ */
+static size_t record_size(size_t len)
+{
+    return HEADER_SIZE + ((len + HEADER_SIZE - 1) & ~(HEADER_SIZE - 1));
+}
+
+static void write_len(struct rt_message_buffer *mb, size_t i, size_t len)
+{
+    memcpy(&mb->arena[i & mb->mask], &len, HEADER_SIZE);
+}
+
+static size_t read_len(const struct rt_message_buffer *mb, size_t i)
+{
+    size_t len;
+    memcpy(&len, &mb->arena[i & mb->mask], HEADER_SIZE);
+    return len;
+}
+
+bool rt_message_buffer_trysend(struct rt_message_buffer *mb, const void *data,
+                               size_t len)
+{
+    if (len > RT_MESSAGE_BUFFER_MAX_LEN(arena_size(mb)))
+    {
+        return false;
+    }
+
+    /* Only the sender writes head, so it can be loaded relaxed. The acquire on
+     * tail ensures the receiver is done with a message before its space is
+     * reused. */
+    size_t head = rt_atomic_load_explicit(&mb->head, memory_order_relaxed);
+    const size_t tail =
+        rt_atomic_load_explicit(&mb->tail, memory_order_acquire);
+    const size_t space = arena_size(mb) - (head - tail);
+    const size_t to_end = arena_size(mb) - (head & mb->mask);
+    const size_t need = record_size(len);
+    const size_t skip = (need > to_end) ? to_end : 0;
+    if ((skip + need) > space)
+    {
+        return false;
+    }
+
+    if (skip != 0)
+    {
+        write_len(mb, head, WRAP_LEN);
+        head += skip;
+    }
+    write_len(mb, head, len);
+    memcpy(&mb->arena[(head + HEADER_SIZE) & mb->mask], data, len);
+    rt_atomic_store_explicit(&mb->head, head + need, memory_order_release);
+    rt_logf("message buffer send: %zu bytes at %zu\n", len, head & mb->mask);
+    rt_sem_post(&mb->recv_sem);
+    return true;
+}
+
+/*
+ * Find the header of the next message, which the caller must have claimed from
+ * recv_sem. Claiming it synchronizes with the sender's post, so the message is
+ * visible.
+ */
+static size_t next_message(const struct rt_message_buffer *mb)
+{
+    const size_t tail =
+        rt_atomic_load_explicit(&mb->tail, memory_order_relaxed);
+    if (read_len(mb, tail) == WRAP_LEN)
+    {
+        return tail + arena_size(mb) - (tail & mb->mask);
+    }
+    return tail;
+}
+
+static size_t receive(struct rt_message_buffer *mb, void *data,
+                      size_t max_len)
+{
+    const size_t i = next_message(mb);
+    const size_t len = read_len(mb, i);
+    memcpy(data, &mb->arena[(i + HEADER_SIZE) & mb->mask],
+           (len < max_len) ? len : max_len);
+    rt_atomic_store_explicit(&mb->tail, i + record_size(len),
+                             memory_order_release);
+    rt_logf("message buffer receive: %zu bytes at %zu\n", len, i & mb->mask);
+    rt_sem_post(&mb->send_sem);
+    return len;
+}
+
+static const void *peek(struct rt_message_buffer *mb, size_t *len)
+{
+    const size_t i = next_message(mb);
+    *len = read_len(mb, i);
+    /* After peeking, the message is still there to be received. */
+    rt_sem_post(&mb->recv_sem);
+    return &mb->arena[(i + HEADER_SIZE) & mb->mask];
+}
+
+void rt_message_buffer_send(struct rt_message_buffer *mb, const void *data,
+                            size_t len)
+{
+    while (!rt_message_buffer_trysend(mb, data, len))
+    {
+        rt_sem_wait(&mb->send_sem);
+    }
+}
+
+size_t rt_message_buffer_receive(struct rt_message_buffer *mb, void *data,
+                                 size_t max_len)
+{
+    rt_sem_wait(&mb->recv_sem);
+    return receive(mb, data, max_len);
+}
+
+bool rt_message_buffer_tryreceive(struct rt_message_buffer *mb, void *data,
+                                  size_t max_len, size_t *len)
+{
+    if (!rt_sem_trywait(&mb->recv_sem))
+    {
+        return false;
+    }
+    *len = receive(mb, data, max_len);
+    return true;
+}
+
+const void *rt_message_buffer_peek(struct rt_message_buffer *mb, size_t *len)
+{
+    rt_sem_wait(&mb->recv_sem);
+    return peek(mb, len);
+}
+
+const void *rt_message_buffer_trypeek(struct rt_message_buffer *mb,
+                                      size_t *len)
+{
+    if (!rt_sem_trywait(&mb->recv_sem))
+    {
+        return NULL;
+    }
+    return peek(mb, len);
+}
+
+bool rt_message_buffer_timedsend(struct rt_message_buffer *mb,
+                                 const void *data, size_t len,
+                                 unsigned long ticks)
+{
+    const unsigned long start_tick = rt_tick();
+    while (!rt_message_buffer_trysend(mb, data, len))
+    {
+        if (!rt_sem_timedwait_since(&mb->send_sem, start_tick, ticks))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool rt_message_buffer_timedreceive(struct rt_message_buffer *mb, void *data,
+                                    size_t max_len, size_t *len,
+                                    unsigned long ticks)
+{
+    if (!rt_sem_timedwait(&mb->recv_sem, ticks))
+    {
+        return false;
+    }
+    *len = receive(mb, data, max_len);
+    return true;
+}
+
+const void *rt_message_buffer_timedpeek(struct rt_message_buffer *mb,
+                                        size_t *len, unsigned long ticks)
+{
+    if (!rt_sem_timedwait(&mb->recv_sem, ticks))
+    {
+        return NULL;
+    }
+    return peek(mb, len);
+}
@@ -0,0 +1,227 @@
+#include <muntos/mpmc_queue.h>
+
+#include <muntos/log.h>
+#include <muntos/task.h>
+
+#include <string.h>
+
+/*
+ * A link holds a node number, which is one more than the node's index, or
+ * zero for the null link, in the low queue->index_bits bits, and a tag that
+ * is incremented each time the link is updated in the rest, so a
+ * compare-exchange on a link fails if it has changed and changed back since
+ * it was loaded.
+ */
+static inline size_t node_mask(const struct rt_mpmc_queue *queue)
+{
+    return ((size_t)1 << queue->index_bits) - (size_t)1;
+}
+
+static inline size_t link_node(const struct rt_mpmc_queue *queue, size_t link)
+{
+    return link & node_mask(queue);
+}
+
+/*
+ * A new value for a link that was prev, pointing to node.
+ */
+static inline size_t link_to(const struct rt_mpmc_queue *queue, size_t prev,
+                             size_t node)
+{
+    return ((prev & ~node_mask(queue)) + ((size_t)1 << queue->index_bits)) |
+           node;
+}
+
+static rt_atomic_size_t *next_ptr(const struct rt_mpmc_queue *queue,
+                                  size_t node)
+{
+    return &queue->next[node - 1];
+}
+
+static void *elem_ptr(const struct rt_mpmc_queue *queue, size_t node)
+{
+    unsigned char *const p = queue->data;
+    return &p[queue->elem_size * (node - 1)];
+}
+
+/*
+ * Take a node from the pool. Returns 0 if the pool is exhausted.
+ */
+static size_t node_alloc(struct rt_mpmc_queue *queue)
+{
+    size_t free = rt_atomic_load_explicit(&queue->free, memory_order_acquire);
+    while (link_node(queue, free) != 0)
+    {
+        /* The node's link may be stale if another allocation takes it first,
+         * but then the tag on the free list will have changed. */
+        const size_t next = rt_atomic_load_explicit(
+            next_ptr(queue, link_node(queue, free)), memory_order_relaxed);
+        if (rt_atomic_compare_exchange_weak_explicit(
+                &queue->free, &free,
+                link_to(queue, free, link_node(queue, next)),
+                memory_order_acquire, memory_order_acquire))
+        {
+            return link_node(queue, free);
+        }
+    }
+
+    size_t unused =
+        rt_atomic_load_explicit(&queue->unused, memory_order_relaxed);
+    while (unused < queue->num_nodes)
+    {
+        if (rt_atomic_compare_exchange_weak_explicit(
+                &queue->unused, &unused, unused + 1, memory_order_relaxed,
+                memory_order_relaxed))
+        {
+            return unused + 1;
+        }
+    }
+    return 0;
+}
+
+static void node_free(struct rt_mpmc_queue *queue, size_t node)
+{
+    rt_atomic_size_t *const node_next = next_ptr(queue, node);
+    const size_t next =
+        rt_atomic_load_explicit(node_next, memory_order_relaxed);
+    size_t free = rt_atomic_load_explicit(&queue->free, memory_order_relaxed);
+    do
+    {
+        rt_atomic_store_explicit(node_next,
+                                 link_to(queue, next, link_node(queue, free)),
+                                 memory_order_relaxed);
+    } while (!rt_atomic_compare_exchange_weak_explicit(
+        &queue->free, &free, link_to(queue, free, node), memory_order_release,
+        memory_order_relaxed));
+}
+
+bool rt_mpmc_queue_push(struct rt_mpmc_queue *queue, const void *elem)
+{
+    const size_t node = node_alloc(queue);
+    if (node == 0)
+    {
+        rt_logf("%s mpmc push failed, pool exhausted\n", rt_task_name());
+        return false;
+    }
+    memcpy(elem_ptr(queue, node), elem, queue->elem_size);
+    rt_atomic_size_t *const node_next = next_ptr(queue, node);
+    rt_atomic_store_explicit(
+        node_next,
+        link_to(queue,
+                rt_atomic_load_explicit(node_next, memory_order_relaxed), 0),
+        memory_order_relaxed);
+
+    for (;;)
+    {
+        size_t tail =
+            rt_atomic_load_explicit(&queue->tail, memory_order_acquire);
+        rt_atomic_size_t *const tail_next =
+            next_ptr(queue, link_node(queue, tail));
+        size_t next = rt_atomic_load_explicit(tail_next, memory_order_acquire);
+        if (tail != rt_atomic_load_explicit(&queue->tail, memory_order_acquire))
+        {
+            continue;
+        }
+        if (link_node(queue, next) == 0)
+        {
+            /* The release publishes the element to consumers that follow the
+             * link to the new node. */
+            if (rt_atomic_compare_exchange_strong_explicit(
+                    tail_next, &next, link_to(queue, next, node),
+                    memory_order_release, memory_order_relaxed))
+            {
+                /* If this fails, another operation has already moved the
+                 * tail past the new node. */
+                rt_atomic_compare_exchange_strong_explicit(
+                    &queue->tail, &tail, link_to(queue, tail, node),
+                    memory_order_release, memory_order_relaxed);
+                break;
+            }
+        }
+        else
+        {
+            /* The tail is behind, so help move it forward. */
+            rt_atomic_compare_exchange_strong_explicit(
+                &queue->tail, &tail,
+                link_to(queue, tail, link_node(queue, next)),
+                memory_order_release, memory_order_relaxed);
+        }
+    }
+    rt_logf("%s mpmc push\n", rt_task_name());
+    rt_sem_post(&queue->sem);
+    return true;
+}
+
+/*
+ * Remove the element at the head of the queue. The caller must have taken a
+ * count from the queue's semaphore, so there is an element to remove.
+ */
+static void dequeue(struct rt_mpmc_queue *queue, void *elem)
+{
+    for (;;)
+    {
+        size_t head =
+            rt_atomic_load_explicit(&queue->head, memory_order_acquire);
+        size_t tail =
+            rt_atomic_load_explicit(&queue->tail, memory_order_acquire);
+        const size_t next = rt_atomic_load_explicit(
+            next_ptr(queue, link_node(queue, head)), memory_order_acquire);
+        if ((head !=
+             rt_atomic_load_explicit(&queue->head, memory_order_acquire)) ||
+            (link_node(queue, next) == 0))
+        {
+            continue;
+        }
+        if (link_node(queue, head) == link_node(queue, tail))
+        {
+            /* The tail is behind, so help move it forward. */
+            rt_atomic_compare_exchange_strong_explicit(
+                &queue->tail, &tail,
+                link_to(queue, tail, link_node(queue, next)),
+                memory_order_release, memory_order_relaxed);
+            continue;
+        }
+        /* The element must be copied before the head moves past its node,
+         * because the node then becomes the placeholder and may be freed and
+         * reused by another pop. If the head has moved, the copy may be torn,
+         * but it is discarded. */
+        memcpy(elem, elem_ptr(queue, link_node(queue, next)),
+               queue->elem_size);
+        if (rt_atomic_compare_exchange_strong_explicit(
+                &queue->head, &head,
+                link_to(queue, head, link_node(queue, next)),
+                memory_order_acq_rel, memory_order_relaxed))
+        {
+            node_free(queue, link_node(queue, head));
+            rt_logf("%s mpmc pop\n", rt_task_name());
+            return;
+        }
+    }
+}
+
+void rt_mpmc_queue_pop(struct rt_mpmc_queue *queue, void *elem)
+{
+    rt_sem_wait(&queue->sem);
+    dequeue(queue, elem);
+}
+
+bool rt_mpmc_queue_trypop(struct rt_mpmc_queue *queue, void *elem)
+{
+    if (!rt_sem_trywait(&queue->sem))
+    {
+        return false;
+    }
+    dequeue(queue, elem);
+    return true;
+}
+
+bool rt_mpmc_queue_timedpop(struct rt_mpmc_queue *queue, void *elem,
+                            unsigned long ticks)
+{
+    if (!rt_sem_timedwait(&queue->sem, ticks))
+    {
+        return false;
+    }
+    dequeue(queue, elem);
+    return true;
+}
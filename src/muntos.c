@@ -4,14 +4,31 @@
 #include <muntos/container.h>
 #include <muntos/context.h>
 #include <muntos/cycle.h>
+#include <muntos/event_group.h>
+#include <muntos/interrupt.h>
 #include <muntos/list.h>
 #include <muntos/log.h>
 #include <muntos/mutex.h>
+#include <muntos/sched.h>
 #include <muntos/sem.h>
 #include <muntos/sleep.h>
 #include <muntos/syscall.h>
 #include <muntos/task.h>
+#if RT_TASK_ENABLE_NOTIFY
+#include <muntos/task_notify.h>
+#endif
 #include <muntos/tick.h>
+#include <muntos/timer.h>
+
+#include "rcu_internal.h"
+#include "timer_internal.h"
+
+#include <assert.h>
+
+/* Every semaphore, and so every queue, mutex, and condition variable, holds a
+ * system call record, so keep the arguments to two words. */
+static_assert(sizeof(union rt_syscall_args) <= 2 * sizeof(unsigned long),
+              "system call arguments are too large");
 
 #define task_from_member(p, m) (rt_container_of((p), struct rt_task, m))
 #define task_from_list(l) (task_from_member(l, list))
@@ -33,11 +50,29 @@ static RT_LIST(ready_list);
 
 static struct rt_syscall_record *_Atomic pending_syscalls;
 
+static rt_atomic_uint sched_lock_depth;
+
+/* Set when the scheduler skips a switch because the scheduler is locked, so
+ * that the outermost unlock runs it again. */
+static rt_atomic_bool sched_deferred;
+
+/* Tasks whose suspend or resume hasn't been handled yet, and the record that
+ * all of them share to make the system call that handles them. */
+static struct rt_task *_Atomic suspend_changes;
+
+static struct rt_syscall_record suspend_record = {
+    .syscall = RT_SYSCALL_TASK_SUSPEND,
+};
+
+static rt_atomic_flag suspend_record_pending = RT_ATOMIC_FLAG_INIT;
+
 static struct rt_task idle_task = {
     .list = RT_LIST_INIT(idle_task.list),
     .sleep_list = RT_LIST_INIT(idle_task.sleep_list),
     .name = "idle",
     .priority = 0,
+    .base_priority = 0,
+    .threshold = 0,
     /* The idle task is initially running. rt_start() is expected to trigger a
      * switch out of it. */
     .state = RT_TASK_STATE_RUNNING,
@@ -62,6 +97,13 @@ struct rt_task *rt_task_self(void)
 
 static void task_ready(struct rt_task *task)
 {
+    /* A suspended task whose wait has ended stays out of the ready list until
+     * it is resumed. */
+    if (task->suspended)
+    {
+        task->state = RT_TASK_STATE_SUSPENDED;
+        return;
+    }
     task->state = RT_TASK_STATE_READY;
     insert_by_priority(&ready_list, task);
 }
@@ -78,6 +120,21 @@ void **rt_context_prev;
 struct rt_mpu_config *rt_mpu_config;
 #endif
 
+/*
+ * Tasks of equal priority take turns, unless the running task has been raised
+ * to its preemption threshold, in which case only tasks with higher priority
+ * than the threshold can preempt it.
+ */
+static bool task_preempts(const struct rt_task *next,
+                          const struct rt_task *task)
+{
+    if (task->priority != task->base_priority)
+    {
+        return next->priority > task->priority;
+    }
+    return next->priority >= task->priority;
+}
+
 static void *sched(void)
 {
     if (rt_list_is_empty(&ready_list))
@@ -98,17 +155,30 @@ static void *sched(void)
 
     const bool still_running = active_task->state == RT_TASK_STATE_RUNNING;
 
-    /* If the active task is still running and has higher priority than the
-     * next task, then continue executing the active task. */
-    if (still_running && (active_task->priority > next_task->priority))
+    /* A task that has the scheduler locked keeps running until it unlocks
+     * it, which will run the scheduler again. This includes a task that has
+     * suspended itself, which is only switched away from at that point. */
+    if (rt_sched_is_locked())
     {
-        rt_logf("sched: %s is still highest priority (%u > %u)\n",
+        rt_logf("sched: %s has the scheduler locked\n", rt_task_name());
+        rt_atomic_store_explicit(&sched_deferred, true, memory_order_relaxed);
+        return NULL;
+    }
+
+    /* If the active task is still running and can't be preempted by the next
+     * task, then continue executing the active task. */
+    if (still_running && !task_preempts(next_task, active_task))
+    {
+        rt_logf("sched: %s is still highest priority (%u, %u)\n",
                 rt_task_name(), active_task->priority, next_task->priority);
         return NULL;
     }
 
-    /* The next task will be used, so remove it from the ready list. */
+    /* The next task will be used, so remove it from the ready list. While it
+     * isn't in any list, raise it to its preemption threshold, which it keeps
+     * if it is preempted, until it next waits. */
     rt_list_remove(&next_task->list);
+    next_task->priority = next_task->threshold;
 
     /* If a task made a system call to suspend itself but was then woken up by
      * its own or another system call and is still the highest priority task,
@@ -116,6 +186,7 @@ static void *sched(void)
     if (active_task == next_task)
     {
         rt_logf("sched: %s was suspended and reawakened\n", rt_task_name());
+        active_task->state = RT_TASK_STATE_RUNNING;
         return NULL;
     }
 
@@ -127,6 +198,11 @@ static void *sched(void)
         task_ready(active_task);
     }
 
+    if (active_task->rcu_nesting != 0)
+    {
+        rt_rcu_switched_out(active_task);
+    }
+
     rt_context_prev = &active_task->ctx;
     active_task = next_task;
     active_task->state = RT_TASK_STATE_RUNNING;
@@ -161,6 +237,66 @@ static void sleep_until(struct rt_task *task, unsigned long wake_tick)
     rt_list_insert_by(&sleep_list, &task->sleep_list, wake_tick_less_than);
 }
 
+/*
+ * Add a task to the ready list, starting the search for its position at
+ * successor, and return the successor to use for the next task. Tasks taken
+ * in order from a list sorted by priority can be merged into the ready list
+ * this way in a single pass, rather than searching the ready list from the
+ * front for each of them.
+ */
+static struct rt_list *task_ready_from(struct rt_list *successor,
+                                       struct rt_task *task)
+{
+    if (task->suspended)
+    {
+        task->state = RT_TASK_STATE_SUSPENDED;
+        return successor;
+    }
+    while ((successor != &ready_list) &&
+           !task_priority_greater_than(&task->list, successor))
+    {
+        successor = successor->next;
+    }
+    task->state = RT_TASK_STATE_READY;
+    rt_list_insert_before(&task->list, successor);
+    return successor;
+}
+
+/*
+ * Handle the mutex for a task that was woken from a condition variable wait.
+ * If the mutex is held, move the task directly to the mutex's wait list, as if
+ * it had called rt_mutex_lock, rather than waking it only to block again.
+ * Returns true if the task should be made ready.
+ */
+static bool cond_waiter_lock(struct rt_task *task)
+{
+    struct rt_sem *const sem = &task->record.args.cond_wait.mutex->sem;
+    /* If the mutex is free, wake the task without taking the mutex for it,
+     * and clear the mutex argument to tell it to lock the mutex when it runs.
+     * Otherwise a higher priority task that locks the mutex before then would
+     * block on a task that hasn't even run yet. */
+    if (rt_atomic_load_explicit(&sem->value, memory_order_relaxed) > 0)
+    {
+        task->record.args.cond_wait.mutex = NULL;
+        return true;
+    }
+    const int value =
+        rt_atomic_fetch_sub_explicit(&sem->value, 1, memory_order_acquire);
+    if (value > 0)
+    {
+        return true;
+    }
+    /* The task is now an ordinary waiter on the mutex, and any timeout no
+     * longer applies. This leaves the cond_wait sem argument non-NULL, which
+     * tells rt_cond_timedwait that it was signaled. */
+    task->record.syscall = RT_SYSCALL_SEM_WAIT;
+    task->record.args.sem_wait.sem = sem;
+    task->state = RT_TASK_STATE_BLOCKED;
+    insert_by_priority(&sem->wait_list, task);
+    ++sem->num_waiters;
+    return false;
+}
+
 static void wake_sem_waiters(struct rt_sem *sem)
 {
     int waiters = -rt_atomic_load_explicit(&sem->value, memory_order_relaxed);
@@ -168,13 +304,151 @@ static void wake_sem_waiters(struct rt_sem *sem)
     {
         waiters = 0;
     }
+    /* The tasks to wake are a prefix of the wait list, which is sorted by
+     * priority like the ready list, so merge them all in one pass. */
+    struct rt_list *successor = rt_list_front(&ready_list);
     while (sem->num_waiters > (size_t)waiters)
     {
         struct rt_task *task =
             task_from_list(rt_list_pop_front(&sem->wait_list));
         rt_list_remove(&task->sleep_list);
-        task_ready(task);
         --sem->num_waiters;
+        if (((task->record.syscall == RT_SYSCALL_COND_WAIT) ||
+             (task->record.syscall == RT_SYSCALL_COND_TIMEDWAIT)) &&
+            !cond_waiter_lock(task))
+        {
+            continue;
+        }
+        successor = task_ready_from(successor, task);
+    }
+}
+
+static void wake_event_group_waiters(struct rt_event_group *group)
+{
+    /* Evaluate every waiter against the same bits in one pass, in priority
+     * order, and only clear bits once all waiters have been evaluated, so one
+     * waiter clearing a bit doesn't hide it from another. */
+    const uint32_t bits = rt_atomic_load(&group->bits);
+    uint32_t clear = 0;
+    struct rt_list *successor = rt_list_front(&ready_list);
+    struct rt_list *node = rt_list_front(&group->wait_list);
+    while (node != &group->wait_list)
+    {
+        struct rt_list *const next = node->next;
+        struct rt_task *const task = task_from_list(node);
+        const uint32_t mask = task->record.args.event_group_wait.mask;
+        const unsigned flags = task->event_group_flags;
+        if (rt_event_group_satisfied(bits, mask, flags))
+        {
+            task->record.args.event_group_wait.bits = bits;
+            /* Only clear the bits that satisfied the wait, so that a bit in
+             * the mask set after they were loaded isn't lost. */
+            if ((flags & RT_EVENT_GROUP_CLEAR) != 0)
+            {
+                clear |= mask & bits;
+            }
+            rt_list_remove(&task->list);
+            rt_list_remove(&task->sleep_list);
+            rt_atomic_fetch_sub_explicit(&group->num_waiters, 1,
+                                         memory_order_relaxed);
+            successor = task_ready_from(successor, task);
+        }
+        node = next;
+    }
+    if (clear != 0)
+    {
+        rt_atomic_fetch_and_explicit(&group->bits, ~clear,
+                                     memory_order_relaxed);
+    }
+}
+
+static RT_LIST(timer_list);
+
+RT_SEM_BINARY(rt_timer_sem, 0);
+struct rt_timer *_Atomic rt_timer_expired = NULL;
+
+static bool timer_expiry_less_than(const struct rt_list *a,
+                                   const struct rt_list *b)
+{
+    const struct rt_timer *const ta = rt_container_of(a, struct rt_timer, list);
+    const struct rt_timer *const tb = rt_container_of(b, struct rt_timer, list);
+    return (ta->expiry - woken_tick) < (tb->expiry - woken_tick);
+}
+
+static void timer_schedule(struct rt_timer *timer, unsigned long expiry)
+{
+    timer->expiry = expiry;
+    rt_list_insert_by(&timer_list, &timer->list, timer_expiry_less_than);
+}
+
+static void timer_syscall(struct rt_timer *timer)
+{
+    /* Allow another command to make a system call while this one is handled,
+     * so that no commands are missed. */
+    rt_atomic_flag_clear_explicit(&timer->command_pending,
+                                  memory_order_release);
+    rt_list_remove(&timer->list);
+    if (rt_atomic_load_explicit(&timer->command, memory_order_acquire) ==
+        RT_TIMER_START)
+    {
+        const unsigned long ticks =
+            rt_atomic_load_explicit(&timer->ticks, memory_order_relaxed);
+        rt_atomic_store_explicit(&timer->active, true, memory_order_relaxed);
+        timer_schedule(timer, woken_tick + ticks);
+    }
+    else
+    {
+        rt_atomic_store_explicit(&timer->active, false, memory_order_relaxed);
+    }
+}
+
+/*
+ * Hand off timers that expire within the next ticks_to_advance ticks to the
+ * timer daemon. A periodic timer that is rescheduled into the same window is
+ * handled again, but it is only pushed once if its callback hasn't run yet.
+ */
+static void expire_timers(unsigned long ticks_to_advance)
+{
+    bool any_expired = false;
+    while (!rt_list_is_empty(&timer_list))
+    {
+        struct rt_timer *const timer =
+            rt_container_of(rt_list_front(&timer_list), struct rt_timer, list);
+        if (ticks_to_advance < (timer->expiry - woken_tick))
+        {
+            break;
+        }
+        rt_list_remove(&timer->list);
+        const unsigned long period =
+            rt_atomic_load_explicit(&timer->period, memory_order_relaxed);
+        if (period != 0)
+        {
+            timer_schedule(timer, timer->expiry + period);
+        }
+        else
+        {
+            rt_atomic_store_explicit(&timer->active, false,
+                                     memory_order_relaxed);
+        }
+        /* A timer whose callback hasn't run yet is still on the daemon's
+         * stack, so it can't be pushed again. */
+        if (!rt_atomic_flag_test_and_set_explicit(&timer->expired,
+                                                  memory_order_acquire))
+        {
+            timer->next_expired = rt_atomic_load_explicit(
+                &rt_timer_expired, memory_order_relaxed);
+            while (!rt_atomic_compare_exchange_weak_explicit(
+                &rt_timer_expired, &timer->next_expired, timer,
+                memory_order_release, memory_order_relaxed))
+            {
+            }
+            any_expired = true;
+        }
+    }
+    if (any_expired)
+    {
+        rt_sem_add_n(&rt_timer_sem, 1);
+        wake_sem_waiters(&rt_timer_sem);
     }
 }
 
@@ -202,9 +476,49 @@ static void tick_syscall(void)
              * setting the sem argument to NULL. */
             task->record.args.sem_timedwait.sem = NULL;
         }
+        else if (task->record.syscall == RT_SYSCALL_COND_TIMEDWAIT)
+        {
+            struct rt_sem *const sem = task->record.args.cond_wait.sem;
+            rt_sem_add_n(sem, 1);
+            rt_list_remove(&task->list);
+            --sem->num_waiters;
+            wake_sem_waiters(sem);
+            task->record.args.cond_wait.sem = NULL;
+        }
+        else if (task->record.syscall == RT_SYSCALL_EVENT_GROUP_TIMEDWAIT)
+        {
+            struct rt_event_group *const group =
+                task->record.args.event_group_wait.group;
+            rt_list_remove(&task->list);
+            rt_atomic_fetch_sub_explicit(&group->num_waiters, 1,
+                                         memory_order_relaxed);
+            /* Signal to the task that its wait timed out by setting the group
+             * argument to NULL. */
+            task->record.args.event_group_wait.group = NULL;
+        }
+#if RT_TASK_ENABLE_NOTIFY
+        else if ((task->record.syscall == RT_SYSCALL_TASK_NOTIFY_TIMEDWAIT) ||
+                 (task->record.syscall == RT_SYSCALL_TASK_NOTIFY))
+        {
+            /* Stop waiting, so a notification after the timeout doesn't try
+             * to wake the task. If a notification already ended the blocked
+             * state, its notifier owns the task's record and its system call
+             * wakes the task, so only stop the timeout. */
+            int state = RT_TASK_NOTIFY_BLOCKED;
+            if (!rt_atomic_compare_exchange_strong_explicit(
+                    &task->notify_state, &state, RT_TASK_NOTIFY_NONE,
+                    memory_order_relaxed, memory_order_relaxed))
+            {
+                rt_list_remove(&task->sleep_list);
+                task->state = RT_TASK_STATE_BLOCKED;
+                continue;
+            }
+        }
+#endif
         rt_list_remove(&task->sleep_list);
         task_ready(task);
     }
+    expire_timers(ticks_to_advance);
     woken_tick += ticks_to_advance;
 }
 
@@ -244,9 +558,221 @@ void rt_syscall(struct rt_syscall_record *record)
                                                      memory_order_relaxed))
     {
     }
-    rt_syscall_pend();
+    /* While the scheduler is locked, the system call is handled along with
+     * any others when it is unlocked, unless it uses the active task's own
+     * record, which must be handled before the task continues. */
+    if (!rt_sched_is_locked() || (record == &active_task->record))
+    {
+        rt_syscall_pend();
+    }
+}
+
+void rt_sched_lock(void)
+{
+    rt_atomic_fetch_add_explicit(&sched_lock_depth, 1, memory_order_relaxed);
 }
 
+void rt_sched_unlock(void)
+{
+    if (rt_atomic_fetch_sub_explicit(&sched_lock_depth, 1,
+                                     memory_order_relaxed) != 1)
+    {
+        return;
+    }
+    /* System calls handled while the scheduler was locked may have readied a
+     * task that should preempt this one, and the scheduler then skipped the
+     * switch, so run it again even if no system calls are pending. */
+    const bool deferred = rt_atomic_exchange_explicit(
+        &sched_deferred, false, memory_order_relaxed);
+    if (deferred ||
+        (rt_atomic_load_explicit(&pending_syscalls, memory_order_relaxed) !=
+         NULL))
+    {
+        rt_logf("%s unlocked the scheduler\n", rt_task_name());
+        rt_syscall_pend();
+    }
+}
+
+bool rt_sched_is_locked(void)
+{
+    return rt_atomic_load_explicit(&sched_lock_depth, memory_order_relaxed) !=
+           0;
+}
+
+/*
+ * Whether a system call made with a task's own record may cause it to wait,
+ * which ends the task's run at its preemption threshold.
+ */
+static bool syscall_may_wait(enum rt_syscall syscall)
+{
+    switch (syscall)
+    {
+    case RT_SYSCALL_SLEEP:
+    case RT_SYSCALL_SLEEP_PERIODIC:
+    case RT_SYSCALL_EXIT:
+    case RT_SYSCALL_SEM_WAIT:
+    case RT_SYSCALL_SEM_TIMEDWAIT:
+    case RT_SYSCALL_COND_WAIT:
+    case RT_SYSCALL_COND_TIMEDWAIT:
+    case RT_SYSCALL_EVENT_GROUP_WAIT:
+    case RT_SYSCALL_EVENT_GROUP_TIMEDWAIT:
+    case RT_SYSCALL_TASK_NOTIFY_WAIT:
+    case RT_SYSCALL_TASK_NOTIFY_TIMEDWAIT:
+        return true;
+    case RT_SYSCALL_TICK:
+    case RT_SYSCALL_SEM_POST:
+    case RT_SYSCALL_TASK_READY:
+    case RT_SYSCALL_EVENT_GROUP_SET:
+    case RT_SYSCALL_TIMER:
+    case RT_SYSCALL_TASK_SET_PRIORITY:
+    case RT_SYSCALL_TASK_SUSPEND:
+    case RT_SYSCALL_TASK_NOTIFY:
+        return false;
+    }
+    return false;
+}
+
+/*
+ * The wait list that a blocked task is in, which is found from the system
+ * call it blocked in.
+ */
+static struct rt_list *task_wait_list(struct rt_task *task)
+{
+    switch (task->record.syscall)
+    {
+    case RT_SYSCALL_SEM_WAIT:
+        return &task->record.args.sem_wait.sem->wait_list;
+    case RT_SYSCALL_SEM_TIMEDWAIT:
+        return &task->record.args.sem_timedwait.sem->wait_list;
+    case RT_SYSCALL_COND_WAIT:
+    case RT_SYSCALL_COND_TIMEDWAIT:
+        return &task->record.args.cond_wait.sem->wait_list;
+    case RT_SYSCALL_EVENT_GROUP_WAIT:
+    case RT_SYSCALL_EVENT_GROUP_TIMEDWAIT:
+        return &task->record.args.event_group_wait.group->wait_list;
+    case RT_SYSCALL_TICK:
+    case RT_SYSCALL_EXIT:
+    case RT_SYSCALL_SLEEP:
+    case RT_SYSCALL_SLEEP_PERIODIC:
+    case RT_SYSCALL_SEM_POST:
+    case RT_SYSCALL_TASK_READY:
+    case RT_SYSCALL_EVENT_GROUP_SET:
+    case RT_SYSCALL_TIMER:
+    case RT_SYSCALL_TASK_SET_PRIORITY:
+    case RT_SYSCALL_TASK_SUSPEND:
+    case RT_SYSCALL_TASK_NOTIFY_WAIT:
+    case RT_SYSCALL_TASK_NOTIFY_TIMEDWAIT:
+    case RT_SYSCALL_TASK_NOTIFY:
+        /* Tasks waiting for a notification don't wait in a list. */
+        return NULL;
+    }
+    return NULL;
+}
+
+struct rt_task_priority_change
+{
+    struct rt_task *const *tasks;
+    const unsigned *priorities;
+    size_t num_tasks;
+};
+
+static void task_set_priority(struct rt_task *task, unsigned priority)
+{
+    /* A task that is running or was preempted at its preemption threshold
+     * stays there. A task without a threshold of its own keeps its threshold
+     * equal to its priority, and a threshold is never below the priority. */
+    const bool raised = task->priority != task->base_priority;
+    if ((task->threshold == task->base_priority) ||
+        (task->threshold < priority))
+    {
+        task->threshold = priority;
+    }
+    task->base_priority = priority;
+    const unsigned new_priority = raised ? task->threshold : priority;
+
+    rt_logf("syscall: %s priority %u -> %u\n", task->name, task->priority,
+            new_priority);
+
+    switch (task->state)
+    {
+    case RT_TASK_STATE_READY:
+        rt_list_remove(&task->list);
+        task->priority = new_priority;
+        insert_by_priority(&ready_list, task);
+        break;
+    case RT_TASK_STATE_BLOCKED:
+    case RT_TASK_STATE_BLOCKED_TIMEOUT:
+    {
+        struct rt_list *const wait_list = task_wait_list(task);
+        task->priority = new_priority;
+        if (wait_list != NULL)
+        {
+            rt_list_remove(&task->list);
+            rt_list_insert_by(wait_list, &task->list,
+                              task_priority_greater_than);
+        }
+        break;
+    }
+    case RT_TASK_STATE_RUNNING:
+    case RT_TASK_STATE_ASLEEP:
+    case RT_TASK_STATE_SUSPENDED:
+    case RT_TASK_STATE_EXITED:
+        task->priority = new_priority;
+        break;
+    }
+}
+
+static void task_suspend_syscall(struct rt_task *task)
+{
+    const bool suspend =
+        rt_atomic_load_explicit(&task->suspend, memory_order_acquire);
+    if (suspend == task->suspended)
+    {
+        return;
+    }
+    task->suspended = suspend;
+    rt_logf("syscall: %s %s\n", task->name, suspend ? "suspend" : "resume");
+    if (!suspend)
+    {
+        if (task->state == RT_TASK_STATE_SUSPENDED)
+        {
+            task_ready(task);
+        }
+        return;
+    }
+    switch (task->state)
+    {
+    case RT_TASK_STATE_READY:
+        rt_list_remove(&task->list);
+        task->state = RT_TASK_STATE_SUSPENDED;
+        break;
+    case RT_TASK_STATE_RUNNING:
+        /* The active task isn't in any list. Suspending it ends its run at
+         * its preemption threshold, like a wait. */
+        task->priority = task->base_priority;
+        task->state = RT_TASK_STATE_SUSPENDED;
+        break;
+    case RT_TASK_STATE_BLOCKED:
+    case RT_TASK_STATE_BLOCKED_TIMEOUT:
+    case RT_TASK_STATE_ASLEEP:
+    case RT_TASK_STATE_SUSPENDED:
+    case RT_TASK_STATE_EXITED:
+        break;
+    }
+}
+
+#if RT_TASK_ENABLE_NOTIFY
+static void task_notify_syscall(struct rt_task *task)
+{
+    rt_logf("syscall: %s notified\n", task->name);
+    if (task->state == RT_TASK_STATE_BLOCKED_TIMEOUT)
+    {
+        rt_list_remove(&task->sleep_list);
+    }
+    task_ready(task);
+}
+#endif
+
 void *rt_syscall_run(void)
 {
 #if RT_TASK_ENABLE_CYCLE
@@ -268,6 +794,16 @@ void *rt_syscall_run(void)
         /* Store the next record in the list now because some syscall records
          * may be re-enabled immediately after they are handled. */
         struct rt_syscall_record *next_record = record->next;
+        /* The active task isn't in any list, so its priority can be lowered
+         * before it is added to a wait list. */
+        if ((record == &active_task->record) &&
+            syscall_may_wait(record->syscall))
+        {
+            /* The task that has the scheduler locked keeps running until it
+             * unlocks it, so it can't wait, sleep, or exit until then. */
+            assert(!rt_sched_is_locked());
+            active_task->priority = active_task->base_priority;
+        }
         switch (record->syscall)
         {
         case RT_SYSCALL_TICK:
@@ -326,6 +862,25 @@ void *rt_syscall_run(void)
             wake_sem_waiters(sem);
             break;
         }
+        case RT_SYSCALL_COND_WAIT:
+        case RT_SYSCALL_COND_TIMEDWAIT:
+        {
+            struct rt_sem *const sem = record->args.cond_wait.sem;
+            struct rt_task *const task = task_from_record(record);
+            if (record->syscall == RT_SYSCALL_COND_TIMEDWAIT)
+            {
+                task->state = RT_TASK_STATE_BLOCKED_TIMEOUT;
+                sleep_until(task, woken_tick + task->wake_tick);
+            }
+            else
+            {
+                task->state = RT_TASK_STATE_BLOCKED;
+            }
+            insert_by_priority(&sem->wait_list, task);
+            ++sem->num_waiters;
+            wake_sem_waiters(sem);
+            break;
+        }
         case RT_SYSCALL_SEM_POST:
         {
             struct rt_sem *const sem = record->args.sem_post.sem;
@@ -343,6 +898,124 @@ void *rt_syscall_run(void)
         case RT_SYSCALL_TASK_READY:
             task_ready(task_from_record(record));
             break;
+        case RT_SYSCALL_EVENT_GROUP_WAIT:
+        case RT_SYSCALL_EVENT_GROUP_TIMEDWAIT:
+        {
+            struct rt_event_group *const group =
+                record->args.event_group_wait.group;
+            struct rt_task *const task = task_from_record(record);
+            if (record->syscall == RT_SYSCALL_EVENT_GROUP_TIMEDWAIT)
+            {
+                task->state = RT_TASK_STATE_BLOCKED_TIMEOUT;
+                sleep_until(task, woken_tick + task->wake_tick);
+            }
+            else
+            {
+                task->state = RT_TASK_STATE_BLOCKED;
+            }
+            insert_by_priority(&group->wait_list, task);
+            /* Register the waiter before loading the bits, so that a
+             * concurrent set either sees the waiter or is seen here. */
+            rt_atomic_fetch_add(&group->num_waiters, 1);
+            wake_event_group_waiters(group);
+            break;
+        }
+        case RT_SYSCALL_EVENT_GROUP_SET:
+        {
+            struct rt_event_group *const group =
+                record->args.event_group_set.group;
+            /* Allow another set from an interrupt to make a system call while
+             * waiters are evaluated so that no sets are missed. */
+            if (record == &group->set_record)
+            {
+                rt_atomic_flag_clear_explicit(&group->set_pending,
+                                              memory_order_release);
+            }
+            wake_event_group_waiters(group);
+            break;
+        }
+        case RT_SYSCALL_TIMER:
+            timer_syscall(record->args.timer.timer);
+            break;
+        case RT_SYSCALL_TASK_SET_PRIORITY:
+        {
+            const struct rt_task_priority_change *const change =
+                record->args.task_set_priority.change;
+            for (size_t i = 0; i < change->num_tasks; ++i)
+            {
+                task_set_priority(change->tasks[i], change->priorities[i]);
+            }
+            break;
+        }
+        case RT_SYSCALL_TASK_SUSPEND:
+        {
+            if (record != &suspend_record)
+            {
+                /* A task suspending itself uses its own record, so that the
+                 * suspend is handled before the task continues. */
+                task_suspend_syscall(task_from_record(record));
+                break;
+            }
+            rt_atomic_flag_clear_explicit(&suspend_record_pending,
+                                          memory_order_release);
+            struct rt_task *task = rt_atomic_exchange_explicit(
+                &suspend_changes, NULL, memory_order_acquire);
+            while (task != NULL)
+            {
+                /* Read the next task before handling this one, because a new
+                 * change can add the task to the list again after that. */
+                struct rt_task *const next = task->suspend_next;
+                /* Allow another suspend or resume to add the task to the list
+                 * again while this one is handled, so that no changes are
+                 * missed. */
+                rt_atomic_flag_clear_explicit(&task->suspend_pending,
+                                              memory_order_release);
+                task_suspend_syscall(task);
+                task = next;
+            }
+            break;
+        }
+#if RT_TASK_ENABLE_NOTIFY
+        case RT_SYSCALL_TASK_NOTIFY_WAIT:
+        case RT_SYSCALL_TASK_NOTIFY_TIMEDWAIT:
+        {
+            struct rt_task *const task = task_from_record(record);
+            /* Read the record before blocking, because a notification after
+             * that takes over the record to wake the task. */
+            const bool timed =
+                record->syscall == RT_SYSCALL_TASK_NOTIFY_TIMEDWAIT;
+            const unsigned long ticks = record->args.task_notify_wait.ticks;
+            /* Only block if no notification arrived since the task started
+             * waiting. A notification after this point will see the task
+             * blocked and wake it. */
+            int state = RT_TASK_NOTIFY_WAITING;
+            if (!rt_atomic_compare_exchange_strong_explicit(
+                    &task->notify_state, &state, RT_TASK_NOTIFY_BLOCKED,
+                    memory_order_acq_rel, memory_order_acquire))
+            {
+                break;
+            }
+            if (timed)
+            {
+                task->state = RT_TASK_STATE_BLOCKED_TIMEOUT;
+                sleep_until(task, woken_tick + ticks);
+            }
+            else
+            {
+                task->state = RT_TASK_STATE_BLOCKED;
+            }
+            break;
+        }
+        case RT_SYSCALL_TASK_NOTIFY:
+            task_notify_syscall(task_from_record(record));
+            break;
+#else
+        case RT_SYSCALL_TASK_NOTIFY_WAIT:
+        case RT_SYSCALL_TASK_NOTIFY_TIMEDWAIT:
+        case RT_SYSCALL_TASK_NOTIFY:
+            /* Only made by task notifications, which are disabled. */
+            break;
+#endif
         }
         record = next_record;
     }
@@ -359,6 +1032,20 @@ static void task_init(struct rt_task *task, const char *name, unsigned priority,
 {
     rt_logf("%s created\n", name);
     task->priority = priority;
+    task->base_priority = priority;
+    task->threshold = priority;
+    task->suspend_next = NULL;
+    rt_atomic_store_explicit(&task->suspend, false, memory_order_relaxed);
+    rt_atomic_flag_clear_explicit(&task->suspend_pending,
+                                  memory_order_relaxed);
+    task->suspended = false;
+    task->rcu_counted = 0;
+    task->rcu_nesting = 0;
+#if RT_TASK_ENABLE_NOTIFY
+    rt_atomic_store_explicit(&task->notify_value, 0, memory_order_relaxed);
+    rt_atomic_store_explicit(&task->notify_state, RT_TASK_NOTIFY_NONE,
+                             memory_order_relaxed);
+#endif
     task->wake_tick = 0;
     task->name = name;
     rt_list_init(&task->sleep_list);
@@ -388,3 +1075,92 @@ void rt_task_init_arg(struct rt_task *task, void (*fn)(uintptr_t),
     task->ctx = rt_context_create_arg(fn, arg, stack, stack_size);
     task_init(task, name, priority, stack, stack_size);
 }
+
+void rt_task_set_priorities(struct rt_task *const *tasks,
+                            const unsigned *priorities, size_t num_tasks)
+{
+    const struct rt_task_priority_change change = {
+        .tasks = tasks,
+        .priorities = priorities,
+        .num_tasks = num_tasks,
+    };
+    struct rt_syscall_record *const record = &active_task->record;
+    record->args.task_set_priority.change = &change;
+    record->syscall = RT_SYSCALL_TASK_SET_PRIORITY;
+    rt_syscall(record);
+}
+
+void rt_task_set_priority(struct rt_task *task, unsigned priority)
+{
+    rt_task_set_priorities(&task, &priority, 1);
+}
+
+static void task_suspend(struct rt_task *task, bool suspend)
+{
+    rt_atomic_store_explicit(&task->suspend, suspend, memory_order_release);
+    if ((task == active_task) && !rt_interrupt_is_active())
+    {
+        /* The current task's own record is free, and using it handles the
+         * suspend immediately, even if the scheduler is locked. */
+        struct rt_syscall_record *const suspend_self = &task->record;
+        suspend_self->syscall = RT_SYSCALL_TASK_SUSPEND;
+        rt_syscall(suspend_self);
+        return;
+    }
+    /* If the task is already in the list of changes, the system call will see
+     * this change when it handles the task, so there is no need to add it. */
+    if (rt_atomic_flag_test_and_set_explicit(&task->suspend_pending,
+                                             memory_order_acquire))
+    {
+        return;
+    }
+    task->suspend_next =
+        rt_atomic_load_explicit(&suspend_changes, memory_order_relaxed);
+    while (!rt_atomic_compare_exchange_weak_explicit(
+        &suspend_changes, &task->suspend_next, task, memory_order_release,
+        memory_order_relaxed))
+    {
+    }
+    if (!rt_atomic_flag_test_and_set_explicit(&suspend_record_pending,
+                                              memory_order_acquire))
+    {
+        rt_syscall(&suspend_record);
+    }
+}
+
+void rt_task_suspend(struct rt_task *task)
+{
+    task_suspend(task, true);
+}
+
+void rt_task_resume(struct rt_task *task)
+{
+    task_suspend(task, false);
+}
+
+static void task_suspend_group(struct rt_task *const *tasks, size_t num_tasks,
+                               bool suspend)
+{
+    /* Defer the system calls so they are all handled in one pass. */
+    rt_sched_lock();
+    for (size_t i = 0; i < num_tasks; ++i)
+    {
+        task_suspend(tasks[i], suspend);
+    }
+    rt_sched_unlock();
+}
+
+void rt_task_suspend_group(struct rt_task *const *tasks, size_t num_tasks)
+{
+    task_suspend_group(tasks, num_tasks, true);
+}
+
+void rt_task_resume_group(struct rt_task *const *tasks, size_t num_tasks)
+{
+    task_suspend_group(tasks, num_tasks, false);
+}
+
+void rt_task_set_threshold(struct rt_task *task, unsigned threshold)
+{
+    task->threshold = threshold;
+}
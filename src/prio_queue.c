@@ -0,0 +1,98 @@
+#include <muntos/prio_queue.h>
+
+#include <muntos/log.h>
+#include <muntos/task.h>
+
+/*
+ * The level queue for a priority. Priorities above the highest level use the
+ * highest level.
+ */
+static struct rt_queue *level(const struct rt_prio_queue *queue,
+                              size_t priority)
+{
+    if (priority >= queue->num_levels)
+    {
+        priority = queue->num_levels - 1;
+    }
+    return queue->levels[priority];
+}
+
+void rt_prio_queue_push(struct rt_prio_queue *queue, size_t priority,
+                        const void *elem)
+{
+    rt_queue_push(level(queue, priority), elem);
+    rt_sem_post(&queue->sem);
+}
+
+bool rt_prio_queue_trypush(struct rt_prio_queue *queue, size_t priority,
+                           const void *elem)
+{
+    if (!rt_queue_trypush(level(queue, priority), elem))
+    {
+        return false;
+    }
+    rt_sem_post(&queue->sem);
+    return true;
+}
+
+bool rt_prio_queue_timedpush(struct rt_prio_queue *queue, size_t priority,
+                             const void *elem, unsigned long ticks)
+{
+    if (!rt_queue_timedpush(level(queue, priority), elem, ticks))
+    {
+        return false;
+    }
+    rt_sem_post(&queue->sem);
+    return true;
+}
+
+/*
+ * Pop the highest priority element. The caller must have taken a count from
+ * the queue's semaphore. Each element is in its level before its count is
+ * posted, so there are always at least as many elements as counts taken. An
+ * element that is queued when a pass starts can only be missed if another
+ * popper takes it during the pass, so each extra pass is paid for by a pop
+ * that completed in the meantime.
+ */
+static void pop_highest(struct rt_prio_queue *queue, void *elem)
+{
+    for (;;)
+    {
+        for (size_t i = queue->num_levels; i > 0; --i)
+        {
+            if (rt_queue_trypop(queue->levels[i - 1], elem))
+            {
+                rt_logf("%s prio queue pop at priority %zu\n",
+                        rt_task_name(), i - 1);
+                return;
+            }
+        }
+    }
+}
+
+void rt_prio_queue_pop(struct rt_prio_queue *queue, void *elem)
+{
+    rt_sem_wait(&queue->sem);
+    pop_highest(queue, elem);
+}
+
+bool rt_prio_queue_trypop(struct rt_prio_queue *queue, void *elem)
+{
+    if (!rt_sem_trywait(&queue->sem))
+    {
+        return false;
+    }
+    pop_highest(queue, elem);
+    return true;
+}
+
+bool rt_prio_queue_timedpop(struct rt_prio_queue *queue, void *elem,
+                            unsigned long ticks)
+{
+    if (!rt_sem_timedwait(&queue->sem, ticks))
+    {
+        return false;
+    }
+    pop_highest(queue, elem);
+    return true;
+}
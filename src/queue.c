@@ -17,6 +17,9 @@
 /* A full slot that has been claimed by a popper/peeker. */
 #define SLOT_POP 0x0AU
 
+/* A full slot that has been claimed exclusively by an acquirer. */
+#define SLOT_ACQUIRED 0x03U
+
 /* An empty slot that has been skipped by a popper. */
 #define SLOT_SKIPPED 0x0CU
 
@@ -28,11 +31,6 @@
 #define SLOT_GEN_INCREMENT (1U << RT_QUEUE_STATE_BITS)
 #define SLOT_GEN_MASK (UCHAR_MAX & ~SLOT_STATE_MASK)
 
-#define Q_GEN_INCREMENT ((size_t)1 << RT_QUEUE_INDEX_BITS)
-#define Q_INDEX_MASK (Q_GEN_INCREMENT - (size_t)1)
-#define Q_GEN_MASK (~Q_INDEX_MASK)
-#define Q_SGEN_SHIFT (RT_QUEUE_INDEX_BITS - RT_QUEUE_STATE_BITS)
-
 static inline unsigned char state(unsigned char slot)
 {
     return slot & SLOT_STATE_MASK;
@@ -43,19 +41,30 @@ static inline unsigned char sgen(unsigned char slot)
     return slot & SLOT_GEN_MASK;
 }
 
-static inline size_t qgen(size_t q)
+/*
+ * Queue indices store the slot index in the low queue->index_bits bits and
+ * the generation in the remaining bits. For queues with a power-of-two number
+ * of elements, index_bits is just enough to hold an index, so incrementing
+ * the last index carries into the generation.
+ */
+static inline size_t qindex_mask(const struct rt_queue *queue)
+{
+    return ((size_t)1 << queue->index_bits) - (size_t)1;
+}
+
+static inline size_t qgen(const struct rt_queue *queue, size_t q)
 {
-    return q & Q_GEN_MASK;
+    return q & ~qindex_mask(queue);
 }
 
-static inline unsigned char qsgen(size_t q)
+static inline unsigned char qsgen(const struct rt_queue *queue, size_t q)
 {
-    return (unsigned char)(qgen(q) >> Q_SGEN_SHIFT);
+    return (unsigned char)((q >> queue->index_bits) << RT_QUEUE_STATE_BITS);
 }
 
-static inline size_t qindex(size_t q)
+static inline size_t qindex(const struct rt_queue *queue, size_t q)
 {
-    return q & Q_INDEX_MASK;
+    return q & qindex_mask(queue);
 }
 
 static const char *state_str(unsigned char state)
@@ -68,6 +77,10 @@ static const char *state_str(unsigned char state)
         return "push";
     case SLOT_POP:
         return "pop";
+    case SLOT_ACQUIRED:
+        return "acquired";
+    case SLOT_SKIPPED:
+        return "skipped";
     case SLOT_FULL:
         return "full";
     default:
@@ -75,17 +88,40 @@ static const char *state_str(unsigned char state)
     }
 }
 
-static size_t next(size_t q, size_t num_elems)
+static size_t next(const struct rt_queue *queue, size_t q)
 {
     q += 1;
-    if (qindex(q) == num_elems)
+    /* Never true for power-of-two queues, where the index wraps by masking. */
+    if (qindex(queue, q) == queue->num_elems)
     {
-        return qgen(q + Q_GEN_INCREMENT);
+        return qgen(queue, q) + ((size_t)1 << queue->index_bits);
     }
     return q;
 }
 
-static void push(struct rt_queue *queue, const void *elem)
+static rt_atomic_uchar *slot_state(const struct rt_queue *queue, size_t i)
+{
+    return (rt_atomic_uchar *)((uintptr_t)queue->slots +
+                               (queue->slot_stride * i));
+}
+
+static void *slot_data(const struct rt_queue *queue, size_t i)
+{
+    unsigned char *const p = queue->data;
+    return &p[queue->elem_stride * i];
+}
+
+static size_t slot_index(const struct rt_queue *queue, const void *elem)
+{
+    const unsigned char *const p = queue->data;
+    return (size_t)((const unsigned char *)elem - p) / queue->elem_stride;
+}
+
+/*
+ * Claim an empty slot for pushing. Returns the index of the slot and stores
+ * the value it was claimed with in *push_s.
+ */
+static size_t push_claim(struct rt_queue *queue, unsigned char *push_s)
 {
     for (;;)
     {
@@ -95,10 +131,11 @@ static void push(struct rt_queue *queue, const void *elem)
         unsigned char s;
         for (;;)
         {
-            slot = &queue->slots[qindex(enq)];
+            slot = slot_state(queue, qindex(queue, enq));
             s = rt_atomic_load_explicit(slot, memory_order_relaxed);
-            rt_logf("push: slot %zu %s\n", qindex(enq), state_str(state(s)));
-            if ((state(s) == SLOT_EMPTY) && (sgen(s) == qsgen(enq)))
+            rt_logf("push: slot %zu %s\n", qindex(queue, enq),
+                    state_str(state(s)));
+            if ((state(s) == SLOT_EMPTY) && (sgen(s) == qsgen(queue, enq)))
             {
                 break;
             }
@@ -111,40 +148,66 @@ static void push(struct rt_queue *queue, const void *elem)
             }
             else
             {
-                enq = next(enq, queue->num_elems);
+                enq = next(queue, enq);
             }
         }
 
-        const unsigned char push_s = sgen(s) | SLOT_PUSH;
-        if (rt_atomic_compare_exchange_strong_explicit(slot, &s, push_s,
+        *push_s = sgen(s) | SLOT_PUSH;
+        if (rt_atomic_compare_exchange_strong_explicit(slot, &s, *push_s,
                                                        memory_order_relaxed,
                                                        memory_order_relaxed))
         {
-            rt_logf("push: slot %zu claimed...\n", qindex(enq));
-            rt_atomic_store_explicit(&queue->enq, next(enq, queue->num_elems),
+            rt_logf("push: slot %zu claimed...\n", qindex(queue, enq));
+            rt_atomic_store_explicit(&queue->enq, next(queue, enq),
                                      memory_order_relaxed);
+            return qindex(queue, enq);
+        }
+    }
+}
 
-            unsigned char *const p = queue->data;
-            memcpy(&p[queue->elem_size * qindex(enq)], elem, queue->elem_size);
+static void push(struct rt_queue *queue, const void *elem)
+{
+    for (;;)
+    {
+        unsigned char s;
+        const size_t i = push_claim(queue, &s);
+        rt_atomic_uchar *const slot = slot_state(queue, i);
 
-            s = push_s;
-            if (rt_atomic_compare_exchange_strong_explicit(
-                    slot, &s, sgen(s) | SLOT_FULL, memory_order_release,
-                    memory_order_relaxed))
-            {
-                break;
-            }
+        memcpy(slot_data(queue, i), elem, queue->elem_size);
 
-            rt_logf("push: slot %zu skipped...\n", qindex(enq));
-            /* If our slot has been skipped by a reader, then restore it
-             * back to empty and keep looking. */
-            while (!rt_atomic_compare_exchange_weak_explicit(
-                slot, &s, sgen(s) | SLOT_EMPTY, memory_order_release,
+        if (rt_atomic_compare_exchange_strong_explicit(
+                slot, &s, sgen(s) | SLOT_FULL, memory_order_release,
                 memory_order_relaxed))
-            {
-            }
+        {
+            break;
         }
+
+        rt_logf("push: slot %zu skipped...\n", i);
+        /* If our slot has been skipped by a reader, then restore it
+         * back to empty and keep looking. */
+        while (!rt_atomic_compare_exchange_weak_explicit(
+            slot, &s, sgen(s) | SLOT_EMPTY, memory_order_release,
+            memory_order_relaxed))
+        {
+        }
+    }
+    rt_sem_post(&queue->pop_sem);
+}
+
+static void commit(struct rt_queue *queue, size_t i)
+{
+    rt_atomic_uchar *const slot = slot_state(queue, i);
+    unsigned char s = rt_atomic_load_explicit(slot, memory_order_relaxed);
+    /* Unlike push, the element can't be written again to another slot, so if
+     * a popper has skipped this slot, publish it in place in the slot's new
+     * generation. Poppers only ever advance the generation of a skipped slot,
+     * so it remains owned by this pusher until it is marked full. */
+    while (!rt_atomic_compare_exchange_weak_explicit(
+        slot, &s, sgen(s) | SLOT_FULL, memory_order_release,
+        memory_order_relaxed))
+    {
     }
+    rt_logf("commit: slot %zu full\n", i);
     rt_sem_post(&queue->pop_sem);
 }
 
@@ -158,10 +221,11 @@ static void pop(struct rt_queue *queue, void *elem)
         unsigned char s;
         for (;;)
         {
-            slot = &queue->slots[qindex(deq)];
+            slot = slot_state(queue, qindex(queue, deq));
             s = rt_atomic_load_explicit(slot, memory_order_relaxed);
-            rt_logf("pop: slot %zu %s\n", qindex(deq), state_str(state(s)));
-            if (sgen(s) == qsgen(deq))
+            rt_logf("pop: slot %zu %s\n", qindex(queue, deq),
+                    state_str(state(s)));
+            if (sgen(s) == qsgen(queue, deq))
             {
                 if ((state(s) == SLOT_PUSH) || (state(s) == SLOT_SKIPPED))
                 {
@@ -177,7 +241,8 @@ static void pop(struct rt_queue *queue, void *elem)
                             slot, &s, skipped_slot, memory_order_relaxed,
                             memory_order_relaxed))
                     {
-                        rt_logf("pop: slot %zu skipped...\n", qindex(deq));
+                        rt_logf("pop: slot %zu skipped...\n",
+                                qindex(queue, deq));
                     }
                 }
                 if ((state(s) == SLOT_FULL) || (state(s) == SLOT_POP))
@@ -194,7 +259,7 @@ static void pop(struct rt_queue *queue, void *elem)
             }
             else
             {
-                deq = next(deq, queue->num_elems);
+                deq = next(queue, deq);
             }
         }
 
@@ -203,10 +268,10 @@ static void pop(struct rt_queue *queue, void *elem)
                                                        memory_order_acquire,
                                                        memory_order_relaxed))
         {
-            rt_logf("pop: slot %zu claimed...\n", qindex(deq));
+            rt_logf("pop: slot %zu claimed...\n", qindex(queue, deq));
 
-            const unsigned char *const p = queue->data;
-            memcpy(elem, &p[queue->elem_size * qindex(deq)], queue->elem_size);
+            memcpy(elem, slot_data(queue, qindex(queue, deq)),
+                   queue->elem_size);
 
             const unsigned char empty_s =
                 (sgen(s) + SLOT_GEN_INCREMENT) | SLOT_EMPTY;
@@ -215,7 +280,7 @@ static void pop(struct rt_queue *queue, void *elem)
                     memory_order_relaxed))
             {
                 rt_atomic_store_explicit(&queue->deq,
-                                         next(deq, queue->num_elems),
+                                         next(queue, deq),
                                          memory_order_relaxed);
                 break;
             }
@@ -236,10 +301,11 @@ static void peek(struct rt_queue *queue, void *elem)
         unsigned char s;
         for (;;)
         {
-            slot = &queue->slots[qindex(deq)];
+            slot = slot_state(queue, qindex(queue, deq));
             s = rt_atomic_load_explicit(slot, memory_order_relaxed);
-            rt_logf("peek: slot %zu %s\n", qindex(deq), state_str(state(s)));
-            if (sgen(s) == qsgen(deq))
+            rt_logf("peek: slot %zu %s\n", qindex(queue, deq),
+                    state_str(state(s)));
+            if (sgen(s) == qsgen(queue, deq))
             {
                 if ((state(s) == SLOT_FULL) || (state(s) == SLOT_POP))
                 {
@@ -255,7 +321,7 @@ static void peek(struct rt_queue *queue, void *elem)
             }
             else
             {
-                deq = next(deq, queue->num_elems);
+                deq = next(queue, deq);
             }
         }
 
@@ -264,10 +330,10 @@ static void peek(struct rt_queue *queue, void *elem)
                                                        memory_order_acquire,
                                                        memory_order_relaxed))
         {
-            rt_logf("peek: slot %zu claimed...\n", qindex(deq));
+            rt_logf("peek: slot %zu claimed...\n", qindex(queue, deq));
 
-            const unsigned char *const p = queue->data;
-            memcpy(elem, &p[queue->elem_size * qindex(deq)], queue->elem_size);
+            memcpy(elem, slot_data(queue, qindex(queue, deq)),
+                   queue->elem_size);
 
             const unsigned char full_s =
                 (sgen(s) + SLOT_GEN_INCREMENT) | SLOT_FULL;
@@ -283,6 +349,79 @@ static void peek(struct rt_queue *queue, void *elem)
     rt_sem_post(&queue->pop_sem);
 }
 
+static size_t acquire(struct rt_queue *queue)
+{
+    /* Similar to pop, but only claim full slots, and claim them exclusively,
+     * because the caller will access the element in place. The dequeue index
+     * can be updated immediately because no other popper can take the slot. */
+    for (;;)
+    {
+        size_t deq = rt_atomic_load_explicit(&queue->deq, memory_order_relaxed);
+        size_t last_deq = deq;
+        rt_atomic_uchar *slot;
+        unsigned char s;
+        for (;;)
+        {
+            slot = slot_state(queue, qindex(queue, deq));
+            s = rt_atomic_load_explicit(slot, memory_order_relaxed);
+            rt_logf("acquire: slot %zu %s\n", qindex(queue, deq),
+                    state_str(state(s)));
+            if (sgen(s) == qsgen(queue, deq))
+            {
+                if ((state(s) == SLOT_PUSH) || (state(s) == SLOT_SKIPPED))
+                {
+                    const unsigned char skipped_slot =
+                        (sgen(s) + SLOT_GEN_INCREMENT) | SLOT_SKIPPED;
+                    if (rt_atomic_compare_exchange_strong_explicit(
+                            slot, &s, skipped_slot, memory_order_relaxed,
+                            memory_order_relaxed))
+                    {
+                        rt_logf("acquire: slot %zu skipped...\n",
+                                qindex(queue, deq));
+                    }
+                }
+                if (state(s) == SLOT_FULL)
+                {
+                    break;
+                }
+            }
+            const size_t new_deq =
+                rt_atomic_load_explicit(&queue->deq, memory_order_relaxed);
+            if (new_deq != last_deq)
+            {
+                deq = new_deq;
+                last_deq = new_deq;
+            }
+            else
+            {
+                deq = next(queue, deq);
+            }
+        }
+
+        if (rt_atomic_compare_exchange_strong_explicit(
+                slot, &s, sgen(s) | SLOT_ACQUIRED, memory_order_acquire,
+                memory_order_relaxed))
+        {
+            rt_logf("acquire: slot %zu claimed...\n", qindex(queue, deq));
+            rt_atomic_store_explicit(&queue->deq, next(queue, deq),
+                                     memory_order_relaxed);
+            return qindex(queue, deq);
+        }
+    }
+}
+
+static void release(struct rt_queue *queue, size_t i)
+{
+    /* An acquired slot is only modified by its owner, so it can be emptied
+     * without a compare-and-swap. */
+    rt_atomic_uchar *const slot = slot_state(queue, i);
+    const unsigned char s = rt_atomic_load_explicit(slot, memory_order_relaxed);
+    rt_atomic_store_explicit(slot, (sgen(s) + SLOT_GEN_INCREMENT) | SLOT_EMPTY,
+                             memory_order_release);
+    rt_logf("release: slot %zu empty\n", i);
+    rt_sem_post(&queue->push_sem);
+}
+
 void rt_queue_push(struct rt_queue *queue, const void *elem)
 {
     rt_sem_wait(&queue->push_sem);
@@ -361,3 +500,64 @@ bool rt_queue_timedpeek(struct rt_queue *queue, void *elem, unsigned long ticks)
     peek(queue, elem);
     return true;
 }
+
+void *rt_queue_reserve(struct rt_queue *queue)
+{
+    rt_sem_wait(&queue->push_sem);
+    unsigned char s;
+    return slot_data(queue, push_claim(queue, &s));
+}
+
+void *rt_queue_tryreserve(struct rt_queue *queue)
+{
+    if (!rt_sem_trywait(&queue->push_sem))
+    {
+        return NULL;
+    }
+    unsigned char s;
+    return slot_data(queue, push_claim(queue, &s));
+}
+
+void *rt_queue_timedreserve(struct rt_queue *queue, unsigned long ticks)
+{
+    if (!rt_sem_timedwait(&queue->push_sem, ticks))
+    {
+        return NULL;
+    }
+    unsigned char s;
+    return slot_data(queue, push_claim(queue, &s));
+}
+
+void rt_queue_commit(struct rt_queue *queue, void *elem)
+{
+    commit(queue, slot_index(queue, elem));
+}
+
+void *rt_queue_acquire(struct rt_queue *queue)
+{
+    rt_sem_wait(&queue->pop_sem);
+    return slot_data(queue, acquire(queue));
+}
+
+void *rt_queue_tryacquire(struct rt_queue *queue)
+{
+    if (!rt_sem_trywait(&queue->pop_sem))
+    {
+        return NULL;
+    }
+    return slot_data(queue, acquire(queue));
+}
+
+void *rt_queue_timedacquire(struct rt_queue *queue, unsigned long ticks)
+{
+    if (!rt_sem_timedwait(&queue->pop_sem, ticks))
+    {
+        return NULL;
+    }
+    return slot_data(queue, acquire(queue));
+}
+
+void rt_queue_release(struct rt_queue *queue, void *elem)
+{
+    release(queue, slot_index(queue, elem));
+}
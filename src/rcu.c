@@ -0,0 +1,144 @@
+#include <muntos/rcu.h>
+
+#include <muntos/log.h>
+#include <muntos/mutex.h>
+#include <muntos/task.h>
+
+#include "rcu_internal.h"
+
+/*
+ * The grace period, and the number of tasks counted in each of the current
+ * and previous grace periods that are still inside a read-side critical
+ * section.
+ */
+static rt_atomic_uint grace_period;
+static rt_atomic_uint readers[2];
+
+static RT_SEM_BINARY(grace_sem, 0);
+static RT_MUTEX(grace_mutex);
+
+void rt_rcu_init(struct rt_rcu *rcu)
+{
+    rt_atomic_store_explicit(&rcu->callbacks, NULL, memory_order_relaxed);
+    rt_sem_init_binary(&rcu->callback_sem, 0);
+}
+
+void rt_rcu_switched_out(struct rt_task *task)
+{
+    /* A task stays counted in the grace period it was first switched out in
+     * until it leaves its critical section. */
+    if (task->rcu_counted == 0)
+    {
+        const unsigned gp = rt_atomic_load(&grace_period);
+        rt_atomic_fetch_add(&readers[gp & 1], 1);
+        task->rcu_counted = (unsigned char)(1 + (gp & 1));
+        rt_logf("%s switched out in rcu read, grace period %u\n", task->name,
+                gp);
+    }
+}
+
+void rt_rcu_read_lock(void)
+{
+    struct rt_task *const task = rt_task_self();
+    ++task->rcu_nesting;
+    /* Only the scheduler interrupts the task to look at its depth, so a
+     * compiler barrier keeps the reads of protected data after the increment
+     * as the scheduler sees it. */
+    rt_atomic_signal_fence(memory_order_seq_cst);
+}
+
+void rt_rcu_read_unlock(void)
+{
+    struct rt_task *const task = rt_task_self();
+    rt_atomic_signal_fence(memory_order_seq_cst);
+    --task->rcu_nesting;
+    rt_atomic_signal_fence(memory_order_seq_cst);
+    /* Once the depth is zero, the scheduler no longer counts the task, so it
+     * can't change rcu_counted while it is read here. */
+    if ((task->rcu_nesting != 0) || (task->rcu_counted == 0))
+    {
+        return;
+    }
+    const unsigned index = task->rcu_counted - 1U;
+    task->rcu_counted = 0;
+    /* The last counted reader of a grace period that has ended wakes the
+     * writer waiting for it. The decrement and the load of the grace period
+     * are sequentially consistent with the writer's advance of the grace
+     * period and load of the count, so either the writer sees the count reach
+     * zero or the reader sees the new grace period. */
+    if ((rt_atomic_fetch_sub(&readers[index], 1) == 1) &&
+        ((rt_atomic_load(&grace_period) & 1) != index))
+    {
+        rt_sem_post(&grace_sem);
+    }
+}
+
+void rt_rcu_synchronize(void)
+{
+    /* Grace periods are serialized, so the tasks counted in the grace period
+     * before the one ending here have already left their critical sections.
+     * Tasks that aren't counted either aren't in a critical section, or
+     * entered it after this call, because every task other than the caller
+     * has been switched out since it last ran. */
+    rt_mutex_lock(&grace_mutex);
+    const unsigned gp = rt_atomic_fetch_add(&grace_period, 1);
+    rt_logf("%s rcu synchronize, grace period %u\n", rt_task_name(), gp);
+    /* The semaphore may have a post left from an earlier grace period, so
+     * check the count again after each wake. */
+    while (rt_atomic_load(&readers[gp & 1]) != 0)
+    {
+        rt_sem_wait(&grace_sem);
+    }
+    rt_mutex_unlock(&grace_mutex);
+}
+
+void rt_rcu_call(struct rt_rcu *rcu, struct rt_rcu_head *head,
+                 void (*fn)(struct rt_rcu_head *))
+{
+    head->fn = fn;
+    head->next = rt_atomic_load_explicit(&rcu->callbacks, memory_order_relaxed);
+    while (!rt_atomic_compare_exchange_weak_explicit(
+        &rcu->callbacks, &head->next, head, memory_order_release,
+        memory_order_relaxed))
+    {
+    }
+    /* Only wake the reclaimer when the list becomes non-empty. Any later
+     * callbacks are taken along with this one, or in the next pass. */
+    if (head->next == NULL)
+    {
+        rt_sem_post(&rcu->callback_sem);
+    }
+}
+
+void rt_rcu_reclaimer(uintptr_t arg)
+{
+    struct rt_rcu *const rcu = (struct rt_rcu *)arg;
+    for (;;)
+    {
+        rt_sem_wait(&rcu->callback_sem);
+
+        /* Callbacks are pushed onto a stack, so reverse it to run them in
+         * order. */
+        struct rt_rcu_head *head = rt_atomic_exchange_explicit(
+            &rcu->callbacks, NULL, memory_order_acquire);
+        struct rt_rcu_head *in_order = NULL;
+        while (head != NULL)
+        {
+            struct rt_rcu_head *const next = head->next;
+            head->next = in_order;
+            in_order = head;
+            head = next;
+        }
+
+        /* Every callback taken was passed after its data was unpublished, so
+         * one grace period from here covers all of them. */
+        rt_rcu_synchronize();
+
+        while (in_order != NULL)
+        {
+            head = in_order;
+            in_order = head->next;
+            head->fn(head);
+        }
+    }
+}
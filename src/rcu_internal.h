@@ -0,0 +1,12 @@
+#ifndef RT_RCU_INTERNAL_H
+#define RT_RCU_INTERNAL_H
+
+#include <muntos/task.h>
+
+/*
+ * Called by the scheduler when it switches out a task that is inside a
+ * read-side critical section, so that grace periods wait for the task.
+ */
+void rt_rcu_switched_out(struct rt_task *task);
+
+#endif /* RT_RCU_INTERNAL_H */
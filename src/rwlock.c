@@ -1,52 +1,77 @@
 #include <muntos/rwlock.h>
 
+#include <muntos/log.h>
+#include <muntos/task.h>
+
 void rt_rwlock_init(struct rt_rwlock *lock)
 {
-    rt_mutex_init(&lock->m);
-    rt_cond_init(&lock->rcond);
-    rt_cond_init(&lock->wcond);
-    lock->num_readers = 0;
-    lock->num_writers = 0;
+    rt_atomic_store_explicit(&lock->readers, 0, memory_order_relaxed);
+    rt_atomic_store_explicit(&lock->departing, 0, memory_order_relaxed);
+    rt_sem_init(&lock->rsem, 0);
+    rt_sem_init(&lock->wsem, 0);
+    rt_mutex_init(&lock->wmutex);
 }
 
 void rt_rwlock_rlock(struct rt_rwlock *lock)
 {
-    rt_mutex_lock(&lock->m);
-    while (lock->num_writers > 0)
+    const int readers =
+        rt_atomic_fetch_add_explicit(&lock->readers, 1, memory_order_acquire);
+    if (readers < 0)
     {
-        rt_cond_wait(&lock->rcond, &lock->m);
+        /* A writer holds or is waiting for the lock. It will post once for
+         * each waiting reader when it unlocks, and this reader will hold the
+         * lock when it wakes. */
+        rt_logf("%s rwlock rlock, waiting for writer\n", rt_task_name());
+        rt_sem_wait(&lock->rsem);
     }
-    ++lock->num_readers;
-    rt_mutex_unlock(&lock->m);
 }
 
 void rt_rwlock_runlock(struct rt_rwlock *lock)
 {
-    rt_mutex_lock(&lock->m);
-    --lock->num_readers;
-    if (lock->num_readers == 0)
+    const int readers =
+        rt_atomic_fetch_sub_explicit(&lock->readers, 1, memory_order_release);
+    if (readers <= 0)
     {
-        rt_cond_broadcast(&lock->wcond);
+        /* A writer is waiting. If this is the last reader it was waiting for,
+         * wake it. */
+        const int departing = rt_atomic_fetch_sub_explicit(
+            &lock->departing, 1, memory_order_acq_rel);
+        if (departing == 1)
+        {
+            rt_sem_post(&lock->wsem);
+        }
     }
-    rt_mutex_unlock(&lock->m);
 }
 
 void rt_rwlock_wlock(struct rt_rwlock *lock)
 {
-    rt_mutex_lock(&lock->m);
-    ++lock->num_writers;
-    while (lock->num_readers > 0)
+    /* Only one writer at a time can announce itself in the readers word. */
+    rt_mutex_lock(&lock->wmutex);
+    const int readers = rt_atomic_fetch_sub_explicit(
+        &lock->readers, RT_RWLOCK_WRITER, memory_order_acquire);
+    /* New readers will now block. Wait for the readers that already hold the
+     * lock to unlock, unless they all did so before the count was added. */
+    if ((readers != 0) &&
+        (rt_atomic_fetch_add_explicit(&lock->departing, readers,
+                                      memory_order_acq_rel) != -readers))
     {
-        rt_cond_wait(&lock->wcond, &lock->m);
+        rt_logf("%s rwlock wlock, waiting for %d readers\n", rt_task_name(),
+                readers);
+        rt_sem_wait(&lock->wsem);
     }
 }
 
 void rt_rwlock_wunlock(struct rt_rwlock *lock)
 {
-    --lock->num_writers;
-    if (lock->num_writers == 0)
+    /* Any readers counted while the writer held the lock are blocked, so
+     * hand the lock to all of them at once. */
+    const int readers =
+        rt_atomic_fetch_add_explicit(&lock->readers, RT_RWLOCK_WRITER,
+                                     memory_order_release) +
+        RT_RWLOCK_WRITER;
+    if (readers > 0)
     {
-        rt_cond_broadcast(&lock->rcond);
+        rt_sem_post_n(&lock->rsem, readers);
     }
-    rt_mutex_unlock(&lock->m);
+    rt_mutex_unlock(&lock->wmutex);
 }
@@ -0,0 +1,108 @@
+#include <muntos/select.h>
+
+#include <muntos/log.h>
+#include <muntos/notify.h>
+#include <muntos/queue.h>
+#include <muntos/task.h>
+#include <muntos/tick.h>
+
+static bool add(struct rt_select *set, struct rt_sem *sem, void *object)
+{
+    if (set->num_members == set->max_members)
+    {
+        return false;
+    }
+    struct rt_select_member *const member = &set->members[set->num_members];
+    member->sem = sem;
+    member->object = object;
+    ++set->num_members;
+    sem->select = set;
+
+    /* Account for posts that happened before the member was added. */
+    const int value =
+        rt_atomic_load_explicit(&sem->value, memory_order_relaxed);
+    if (value > 0)
+    {
+        rt_sem_post_n(&set->sem, value);
+    }
+    return true;
+}
+
+bool rt_select_add_sem(struct rt_select *set, struct rt_sem *sem)
+{
+    return add(set, sem, sem);
+}
+
+bool rt_select_add_queue(struct rt_select *set, struct rt_queue *queue)
+{
+    return add(set, &queue->pop_sem, queue);
+}
+
+bool rt_select_add_notify(struct rt_select *set, struct rt_notify *note)
+{
+    return add(set, &note->sem, note);
+}
+
+/*
+ * Find the first ready member after claiming a post from the set. The set is
+ * posted at least once for each post to a member that the waiting task hasn't
+ * consumed yet, but binary members coalesce posts, so a claimed post may not
+ * correspond to a ready member.
+ */
+static void *ready(const struct rt_select *set)
+{
+    for (size_t i = 0; i < set->num_members; ++i)
+    {
+        const struct rt_select_member *const member = &set->members[i];
+        if (rt_atomic_load_explicit(&member->sem->value,
+                                    memory_order_acquire) > 0)
+        {
+            rt_logf("%s select member %zu ready\n", rt_task_name(), i);
+            return member->object;
+        }
+    }
+    return NULL;
+}
+
+void *rt_select_wait(struct rt_select *set)
+{
+    for (;;)
+    {
+        rt_sem_wait(&set->sem);
+        void *const object = ready(set);
+        if (object != NULL)
+        {
+            return object;
+        }
+    }
+}
+
+void *rt_select_trywait(struct rt_select *set)
+{
+    while (rt_sem_trywait(&set->sem))
+    {
+        void *const object = ready(set);
+        if (object != NULL)
+        {
+            return object;
+        }
+    }
+    return NULL;
+}
+
+void *rt_select_timedwait(struct rt_select *set, unsigned long ticks)
+{
+    const unsigned long start_tick = rt_tick();
+    for (;;)
+    {
+        if (!rt_sem_timedwait_since(&set->sem, start_tick, ticks))
+        {
+            return NULL;
+        }
+        void *const object = ready(set);
+        if (object != NULL)
+        {
+            return object;
+        }
+    }
+}
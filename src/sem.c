@@ -2,7 +2,10 @@
 
 #include <muntos/interrupt.h>
 #include <muntos/log.h>
+#include <muntos/sched.h>
+#include <muntos/select.h>
 #include <muntos/task.h>
+#include <muntos/tick.h>
 
 void rt_sem_init_max(struct rt_sem *sem, int count, int max)
 {
@@ -13,6 +16,7 @@ void rt_sem_init_max(struct rt_sem *sem, int count, int max)
     rt_atomic_store_explicit(&sem->value, count, memory_order_relaxed);
     sem->num_waiters = 0;
     rt_atomic_flag_clear_explicit(&sem->post_pending, memory_order_release);
+    sem->select = NULL;
 }
 
 void rt_sem_init(struct rt_sem *sem, int count)
@@ -38,8 +42,10 @@ static void sem_post_syscall(struct rt_sem *sem, int n)
 {
     /* In an interrupt, we need to use the post system call record attached to
      * the semaphore rather than allocating one on the stack, because the
-     * system call will run after the interrupt has returned. */
-    if (rt_interrupt_is_active())
+     * system call will run after the interrupt has returned. The same applies
+     * to a task that has the scheduler locked, because the system call is
+     * deferred until the scheduler is unlocked. */
+    if (rt_interrupt_is_active() || rt_sched_is_locked())
     {
         /* If the semaphore's post record is already pending, don't attempt to
          * use it again. The interrupt that is using it will still cause the
@@ -77,6 +83,7 @@ static void sem_post_syscall(struct rt_sem *sem, int n)
 void rt_sem_post_n(struct rt_sem *sem, int n)
 {
     int value = rt_atomic_load_explicit(&sem->value, memory_order_relaxed);
+    int value_after;
     do
     {
         if (value < 0)
@@ -86,9 +93,17 @@ void rt_sem_post_n(struct rt_sem *sem, int n)
             sem_post_syscall(sem, n);
             return;
         }
+        value_after = new_value(value, n, sem->max_value);
     } while (!rt_atomic_compare_exchange_weak_explicit(
-        &sem->value, &value, new_value(value, n, sem->max_value),
-        memory_order_release, memory_order_relaxed));
+        &sem->value, &value, value_after, memory_order_release,
+        memory_order_relaxed));
+
+    /* A semaphore in a select set has no direct waiters, so its posts always
+     * take the path above. Only count posts that made it more available. */
+    if ((sem->select != NULL) && (value_after > value))
+    {
+        rt_sem_post_n(&sem->select->sem, value_after - value);
+    }
 }
 
 void rt_sem_post(struct rt_sem *sem)
@@ -156,6 +171,17 @@ bool rt_sem_timedwait(struct rt_sem *sem, unsigned long ticks)
     return wait_record->args.sem_timedwait.sem != NULL;
 }
 
+bool rt_sem_timedwait_since(struct rt_sem *sem, unsigned long start_tick,
+                            unsigned long ticks)
+{
+    const unsigned long ticks_waited = rt_tick() - start_tick;
+    if (ticks_waited >= ticks)
+    {
+        return rt_sem_trywait(sem);
+    }
+    return rt_sem_timedwait(sem, ticks - ticks_waited);
+}
+
 void rt_sem_add_n(struct rt_sem *sem, int n)
 {
     int value = rt_atomic_load_explicit(&sem->value, memory_order_relaxed);
@@ -0,0 +1,40 @@
+#include <muntos/seqlock.h>
+
+void rt_seqlock_init(struct rt_seqlock *lock)
+{
+    rt_atomic_store_explicit(&lock->seq, 0, memory_order_relaxed);
+}
+
+unsigned rt_seqlock_read_begin(const struct rt_seqlock *lock)
+{
+    /* Synchronizes with the release in rt_seqlock_write_end, so the data
+     * from the last complete write is visible to the reader. */
+    return rt_atomic_load_explicit(&lock->seq, memory_order_acquire);
+}
+
+bool rt_seqlock_read_retry(const struct rt_seqlock *lock, unsigned seq)
+{
+    /* Order the reader's loads of the data before the second load of the
+     * sequence number, so that if any of them saw a concurrent write, the
+     * sequence number will have changed. */
+    rt_atomic_thread_fence(memory_order_acquire);
+    return ((seq & 1) != 0) ||
+           (rt_atomic_load_explicit(&lock->seq, memory_order_relaxed) != seq);
+}
+
+void rt_seqlock_write_begin(struct rt_seqlock *lock)
+{
+    const unsigned seq =
+        rt_atomic_load_explicit(&lock->seq, memory_order_relaxed);
+    rt_atomic_store_explicit(&lock->seq, seq + 1, memory_order_relaxed);
+    /* Order the odd sequence number before the writer's stores to the data,
+     * so a reader that sees any of them also sees the write in progress. */
+    rt_atomic_thread_fence(memory_order_release);
+}
+
+void rt_seqlock_write_end(struct rt_seqlock *lock)
+{
+    const unsigned seq =
+        rt_atomic_load_explicit(&lock->seq, memory_order_relaxed);
+    rt_atomic_store_explicit(&lock->seq, seq + 1, memory_order_release);
+}
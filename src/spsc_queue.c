@@ -0,0 +1,138 @@
+#include <muntos/spsc_queue.h>
+
+#include "waiter.h"
+
+#include <muntos/log.h>
+#include <muntos/tick.h>
+
+#include <string.h>
+
+static void *elem_ptr(const struct rt_spsc_queue *queue, size_t q)
+{
+    unsigned char *const p = queue->data;
+    return &p[queue->elem_size * (q & queue->mask)];
+}
+
+bool rt_spsc_queue_trypush(struct rt_spsc_queue *queue, const void *elem)
+{
+    /* Only the producer writes enq, so it can be loaded relaxed. The acquire
+     * on deq ensures the consumer is done reading a slot before it's reused. */
+    const size_t enq =
+        rt_atomic_load_explicit(&queue->enq, memory_order_relaxed);
+    const size_t deq =
+        rt_atomic_load_explicit(&queue->deq, memory_order_acquire);
+    if ((enq - deq) > queue->mask)
+    {
+        return false;
+    }
+    memcpy(elem_ptr(queue, enq), elem, queue->elem_size);
+    rt_atomic_store_explicit(&queue->enq, enq + 1, memory_order_release);
+    rt_logf("spsc push: %zu\n", enq & queue->mask);
+    rt_waiter_wake(&queue->pop_waiting, &queue->pop_sem);
+    return true;
+}
+
+static bool trypop(struct rt_spsc_queue *queue, void *elem, bool advance)
+{
+    const size_t deq =
+        rt_atomic_load_explicit(&queue->deq, memory_order_relaxed);
+    const size_t enq =
+        rt_atomic_load_explicit(&queue->enq, memory_order_acquire);
+    if (enq == deq)
+    {
+        return false;
+    }
+    memcpy(elem, elem_ptr(queue, deq), queue->elem_size);
+    if (advance)
+    {
+        rt_atomic_store_explicit(&queue->deq, deq + 1, memory_order_release);
+        rt_logf("spsc pop: %zu\n", deq & queue->mask);
+        rt_waiter_wake(&queue->push_waiting, &queue->push_sem);
+    }
+    return true;
+}
+
+bool rt_spsc_queue_trypop(struct rt_spsc_queue *queue, void *elem)
+{
+    return trypop(queue, elem, true);
+}
+
+bool rt_spsc_queue_trypeek(struct rt_spsc_queue *queue, void *elem)
+{
+    return trypop(queue, elem, false);
+}
+
+void rt_spsc_queue_push(struct rt_spsc_queue *queue, const void *elem)
+{
+    bool announced = false;
+    while (!rt_spsc_queue_trypush(queue, elem))
+    {
+        rt_waiter_wait(&queue->push_waiting, &queue->push_sem, &announced);
+    }
+    rt_waiter_done(&queue->push_waiting, announced);
+}
+
+void rt_spsc_queue_pop(struct rt_spsc_queue *queue, void *elem)
+{
+    bool announced = false;
+    while (!rt_spsc_queue_trypop(queue, elem))
+    {
+        rt_waiter_wait(&queue->pop_waiting, &queue->pop_sem, &announced);
+    }
+    rt_waiter_done(&queue->pop_waiting, announced);
+}
+
+void rt_spsc_queue_peek(struct rt_spsc_queue *queue, void *elem)
+{
+    bool announced = false;
+    while (!rt_spsc_queue_trypeek(queue, elem))
+    {
+        rt_waiter_wait(&queue->pop_waiting, &queue->pop_sem, &announced);
+    }
+    rt_waiter_done(&queue->pop_waiting, announced);
+}
+
+bool rt_spsc_queue_timedpush(struct rt_spsc_queue *queue, const void *elem,
+                             unsigned long ticks)
+{
+    const unsigned long start_tick = rt_tick();
+    bool announced = false;
+    bool ok = true;
+    while (ok && !rt_spsc_queue_trypush(queue, elem))
+    {
+        ok = rt_waiter_timedwait(&queue->push_waiting, &queue->push_sem,
+                                 &announced, start_tick, ticks);
+    }
+    rt_waiter_done(&queue->push_waiting, announced);
+    return ok;
+}
+
+bool rt_spsc_queue_timedpop(struct rt_spsc_queue *queue, void *elem,
+                            unsigned long ticks)
+{
+    const unsigned long start_tick = rt_tick();
+    bool announced = false;
+    bool ok = true;
+    while (ok && !rt_spsc_queue_trypop(queue, elem))
+    {
+        ok = rt_waiter_timedwait(&queue->pop_waiting, &queue->pop_sem,
+                                 &announced, start_tick, ticks);
+    }
+    rt_waiter_done(&queue->pop_waiting, announced);
+    return ok;
+}
+
+bool rt_spsc_queue_timedpeek(struct rt_spsc_queue *queue, void *elem,
+                             unsigned long ticks)
+{
+    const unsigned long start_tick = rt_tick();
+    bool announced = false;
+    bool ok = true;
+    while (ok && !rt_spsc_queue_trypeek(queue, elem))
+    {
+        ok = rt_waiter_timedwait(&queue->pop_waiting, &queue->pop_sem,
+                                 &announced, start_tick, ticks);
+    }
+    rt_waiter_done(&queue->pop_waiting, announced);
+    return ok;
+}
@@ -0,0 +1,242 @@
+#include <muntos/stream_buffer.h>
+
+#include "waiter.h"
+
+#include <muntos/log.h>
+#include <muntos/tick.h>
+
+#include <string.h>
+
+static size_t size(const struct rt_stream_buffer *sb)
+{
+    return sb->mask + 1;
+}
+
+size_t rt_stream_buffer_available(const struct rt_stream_buffer *sb)
+{
+    const size_t tail =
+        rt_atomic_load_explicit(&sb->tail, memory_order_relaxed);
+    const size_t head =
+        rt_atomic_load_explicit(&sb->head, memory_order_acquire);
+    return head - tail;
+}
+
+size_t rt_stream_buffer_write_region(struct rt_stream_buffer *sb, void **data)
+{
+    /* Only the writer writes head, so it can be loaded relaxed. The acquire on
+     * tail ensures the reader is done with bytes before they're reused. */
+    const size_t head =
+        rt_atomic_load_explicit(&sb->head, memory_order_relaxed);
+    const size_t tail =
+        rt_atomic_load_explicit(&sb->tail, memory_order_acquire);
+    const size_t space = size(sb) - (head - tail);
+    const size_t to_end = size(sb) - (head & sb->mask);
+    *data = &sb->data[head & sb->mask];
+    return (space < to_end) ? space : to_end;
+}
+
+void rt_stream_buffer_commit(struct rt_stream_buffer *sb, size_t len)
+{
+    const size_t head =
+        rt_atomic_load_explicit(&sb->head, memory_order_relaxed) + len;
+    rt_atomic_store_explicit(&sb->head, head, memory_order_release);
+    rt_logf("stream buffer commit: %zu\n", len);
+    /* The reader sets its trigger level before announcing that it's waiting,
+     * so the fence in rt_waiter_is_waiting makes the level visible here. A
+     * stale tail can only overstate the available bytes. */
+    if (!rt_waiter_is_waiting(&sb->read_waiting))
+    {
+        return;
+    }
+    const size_t tail =
+        rt_atomic_load_explicit(&sb->tail, memory_order_relaxed);
+    if (((head - tail) >= rt_atomic_load_explicit(&sb->trigger,
+                                                   memory_order_relaxed)) &&
+        rt_atomic_exchange_explicit(&sb->read_waiting, false,
+                                    memory_order_relaxed))
+    {
+        rt_sem_post(&sb->read_sem);
+    }
+}
+
+size_t rt_stream_buffer_read_region(struct rt_stream_buffer *sb,
+                                    const void **data)
+{
+    const size_t tail =
+        rt_atomic_load_explicit(&sb->tail, memory_order_relaxed);
+    const size_t head =
+        rt_atomic_load_explicit(&sb->head, memory_order_acquire);
+    const size_t available = head - tail;
+    const size_t to_end = size(sb) - (tail & sb->mask);
+    *data = &sb->data[tail & sb->mask];
+    return (available < to_end) ? available : to_end;
+}
+
+void rt_stream_buffer_consume(struct rt_stream_buffer *sb, size_t len)
+{
+    const size_t tail =
+        rt_atomic_load_explicit(&sb->tail, memory_order_relaxed) + len;
+    rt_atomic_store_explicit(&sb->tail, tail, memory_order_release);
+    rt_logf("stream buffer consume: %zu\n", len);
+    rt_waiter_wake(&sb->write_waiting, &sb->write_sem);
+}
+
+/*
+ * Copy len bytes between a linear buffer and the ring starting at index i,
+ * splitting the copy where the ring wraps around.
+ */
+static void copy_in(struct rt_stream_buffer *sb, size_t i, const void *data,
+                    size_t len)
+{
+    const unsigned char *const src = data;
+    const size_t to_end = size(sb) - (i & sb->mask);
+    const size_t first = (len < to_end) ? len : to_end;
+    memcpy(&sb->data[i & sb->mask], src, first);
+    memcpy(sb->data, &src[first], len - first);
+}
+
+static void copy_out(const struct rt_stream_buffer *sb, size_t i, void *data,
+                     size_t len)
+{
+    unsigned char *const dst = data;
+    const size_t to_end = size(sb) - (i & sb->mask);
+    const size_t first = (len < to_end) ? len : to_end;
+    memcpy(dst, &sb->data[i & sb->mask], first);
+    memcpy(&dst[first], sb->data, len - first);
+}
+
+size_t rt_stream_buffer_trywrite(struct rt_stream_buffer *sb, const void *data,
+                                 size_t len)
+{
+    const size_t head =
+        rt_atomic_load_explicit(&sb->head, memory_order_relaxed);
+    const size_t tail =
+        rt_atomic_load_explicit(&sb->tail, memory_order_acquire);
+    const size_t space = size(sb) - (head - tail);
+    if (len > space)
+    {
+        len = space;
+    }
+    if (len > 0)
+    {
+        copy_in(sb, head, data, len);
+        rt_stream_buffer_commit(sb, len);
+    }
+    return len;
+}
+
+size_t rt_stream_buffer_tryread(struct rt_stream_buffer *sb, void *data,
+                                size_t len)
+{
+    const size_t tail =
+        rt_atomic_load_explicit(&sb->tail, memory_order_relaxed);
+    const size_t head =
+        rt_atomic_load_explicit(&sb->head, memory_order_acquire);
+    const size_t available = head - tail;
+    if (len > available)
+    {
+        len = available;
+    }
+    if (len > 0)
+    {
+        copy_out(sb, tail, data, len);
+        rt_stream_buffer_consume(sb, len);
+    }
+    return len;
+}
+
+void rt_stream_buffer_set_trigger(struct rt_stream_buffer *sb, size_t level)
+{
+    if (level == 0)
+    {
+        level = 1;
+    }
+    else if (level > size(sb))
+    {
+        level = size(sb);
+    }
+    rt_atomic_store(&sb->trigger, level);
+}
+
+static bool triggered(const struct rt_stream_buffer *sb)
+{
+    const size_t tail =
+        rt_atomic_load_explicit(&sb->tail, memory_order_relaxed);
+    const size_t head =
+        rt_atomic_load_explicit(&sb->head, memory_order_acquire);
+    return (head - tail) >=
+           rt_atomic_load_explicit(&sb->trigger, memory_order_relaxed);
+}
+
+void rt_stream_buffer_write(struct rt_stream_buffer *sb, const void *data,
+                            size_t len)
+{
+    const unsigned char *src = data;
+    bool announced = false;
+    for (;;)
+    {
+        const size_t n = rt_stream_buffer_trywrite(sb, src, len);
+        src += n;
+        len -= n;
+        if (len == 0)
+        {
+            rt_waiter_done(&sb->write_waiting, announced);
+            return;
+        }
+        if (n == 0)
+        {
+            rt_waiter_wait(&sb->write_waiting, &sb->write_sem, &announced);
+        }
+    }
+}
+
+size_t rt_stream_buffer_read(struct rt_stream_buffer *sb, void *data,
+                             size_t len)
+{
+    bool announced = false;
+    while (!triggered(sb))
+    {
+        rt_waiter_wait(&sb->read_waiting, &sb->read_sem, &announced);
+    }
+    rt_waiter_done(&sb->read_waiting, announced);
+    return rt_stream_buffer_tryread(sb, data, len);
+}
+
+size_t rt_stream_buffer_timedwrite(struct rt_stream_buffer *sb,
+                                   const void *data, size_t len,
+                                   unsigned long ticks)
+{
+    const unsigned long start_tick = rt_tick();
+    const unsigned char *src = data;
+    size_t written = 0;
+    bool announced = false;
+    for (;;)
+    {
+        const size_t n =
+            rt_stream_buffer_trywrite(sb, &src[written], len - written);
+        written += n;
+        if ((written == len) ||
+            ((n == 0) &&
+             !rt_waiter_timedwait(&sb->write_waiting, &sb->write_sem,
+                                  &announced, start_tick, ticks)))
+        {
+            rt_waiter_done(&sb->write_waiting, announced);
+            return written;
+        }
+    }
+}
+
+size_t rt_stream_buffer_timedread(struct rt_stream_buffer *sb, void *data,
+                                  size_t len, unsigned long ticks)
+{
+    const unsigned long start_tick = rt_tick();
+    bool announced = false;
+    bool ok = true;
+    while (ok && !triggered(sb))
+    {
+        ok = rt_waiter_timedwait(&sb->read_waiting, &sb->read_sem, &announced,
+                                 start_tick, ticks);
+    }
+    rt_waiter_done(&sb->read_waiting, announced);
+    return rt_stream_buffer_tryread(sb, data, len);
+}
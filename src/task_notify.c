@@ -0,0 +1,157 @@
+#include <muntos/task.h>
+
+#if RT_TASK_ENABLE_NOTIFY
+
+#include <muntos/task_notify.h>
+
+#include <muntos/log.h>
+
+static void notify(struct rt_task *task)
+{
+    /* The value is updated before the notification is made pending, so the
+     * receiver sees the update once it has taken the notification. */
+    if (rt_atomic_exchange_explicit(&task->notify_state,
+                                    RT_TASK_NOTIFY_PENDING,
+                                    memory_order_acq_rel) ==
+        RT_TASK_NOTIFY_BLOCKED)
+    {
+        /* Only the notifier that ends the blocked state gets here, and the
+         * blocked task isn't using its record, so use it to wake the task. */
+        struct rt_syscall_record *const notify_record = &task->record;
+        notify_record->syscall = RT_SYSCALL_TASK_NOTIFY;
+        rt_syscall(notify_record);
+    }
+}
+
+void rt_task_notify(struct rt_task *task)
+{
+    notify(task);
+}
+
+void rt_task_notify_set(struct rt_task *task, uint32_t value)
+{
+    rt_atomic_store_explicit(&task->notify_value, value,
+                             memory_order_relaxed);
+    notify(task);
+}
+
+void rt_task_notify_or(struct rt_task *task, uint32_t value)
+{
+    rt_atomic_fetch_or_explicit(&task->notify_value, value,
+                                memory_order_relaxed);
+    notify(task);
+}
+
+void rt_task_notify_add(struct rt_task *task, uint32_t value)
+{
+    rt_atomic_fetch_add_explicit(&task->notify_value, value,
+                                 memory_order_relaxed);
+    notify(task);
+}
+
+void rt_task_notify_increment(struct rt_task *task)
+{
+    rt_task_notify_add(task, 1);
+}
+
+static bool take(struct rt_task *task)
+{
+    return rt_atomic_exchange_explicit(&task->notify_state,
+                                       RT_TASK_NOTIFY_NONE,
+                                       memory_order_acquire) ==
+           RT_TASK_NOTIFY_PENDING;
+}
+
+/*
+ * Wait for a notification to the current task, with a timeout if timed is
+ * true. Returns true if the task was notified.
+ */
+static bool wait(bool timed, unsigned long ticks)
+{
+    struct rt_task *const task = rt_task_self();
+    int state = RT_TASK_NOTIFY_NONE;
+    if (rt_atomic_compare_exchange_strong_explicit(
+            &task->notify_state, &state, RT_TASK_NOTIFY_WAITING,
+            memory_order_relaxed, memory_order_relaxed))
+    {
+        /* The system call only blocks the task if it is still waiting, and a
+         * notification wakes it once it is blocked, so a notification between
+         * here and the system call isn't missed. */
+        rt_logf("%s waiting for notification\n", rt_task_name());
+        struct rt_syscall_record *const wait_record = &task->record;
+        wait_record->args.task_notify_wait.ticks = ticks;
+        wait_record->syscall = timed ? RT_SYSCALL_TASK_NOTIFY_TIMEDWAIT
+                                     : RT_SYSCALL_TASK_NOTIFY_WAIT;
+        rt_syscall(wait_record);
+    }
+    /* After a timeout, the state is only pending if a notification arrived
+     * at the same time, so it is taken. */
+    return take(task);
+}
+
+uint32_t rt_task_notify_wait(void)
+{
+    while (!wait(false, 0))
+    {
+    }
+    return rt_atomic_load_explicit(&rt_task_self()->notify_value,
+                                   memory_order_relaxed);
+}
+
+uint32_t rt_task_notify_wait_clear(uint32_t clear)
+{
+    while (!wait(false, 0))
+    {
+    }
+    return rt_atomic_fetch_and_explicit(&rt_task_self()->notify_value, ~clear,
+                                        memory_order_relaxed);
+}
+
+bool rt_task_notify_trywait(uint32_t *value)
+{
+    struct rt_task *const task = rt_task_self();
+    if (!take(task))
+    {
+        return false;
+    }
+    *value = rt_atomic_load_explicit(&task->notify_value, memory_order_relaxed);
+    return true;
+}
+
+bool rt_task_notify_trywait_clear(uint32_t clear, uint32_t *value)
+{
+    struct rt_task *const task = rt_task_self();
+    if (!take(task))
+    {
+        return false;
+    }
+    *value = rt_atomic_fetch_and_explicit(&task->notify_value, ~clear,
+                                          memory_order_relaxed);
+    return true;
+}
+
+bool rt_task_notify_timedwait(uint32_t *value, unsigned long ticks)
+{
+    struct rt_task *const task = rt_task_self();
+    if (!wait(true, ticks))
+    {
+        return false;
+    }
+    *value = rt_atomic_load_explicit(&task->notify_value, memory_order_relaxed);
+    return true;
+}
+
+bool rt_task_notify_timedwait_clear(uint32_t clear, uint32_t *value,
+                                    unsigned long ticks)
+{
+    struct rt_task *const task = rt_task_self();
+    if (!wait(true, ticks))
+    {
+        return false;
+    }
+    *value = rt_atomic_fetch_and_explicit(&task->notify_value, ~clear,
+                                          memory_order_relaxed);
+    return true;
+}
+
+#endif /* RT_TASK_ENABLE_NOTIFY */
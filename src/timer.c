@@ -0,0 +1,99 @@
+#include <muntos/timer.h>
+
+#include <muntos/log.h>
+#include <muntos/task.h>
+
+#include "timer_internal.h"
+
+void rt_timer_init(struct rt_timer *timer, void (*fn)(uintptr_t),
+                   uintptr_t arg)
+{
+    rt_list_init(&timer->list);
+    timer->next_expired = NULL;
+    timer->fn = fn;
+    timer->arg = arg;
+    rt_atomic_store_explicit(&timer->ticks, 0, memory_order_relaxed);
+    rt_atomic_store_explicit(&timer->period, 0, memory_order_relaxed);
+    timer->expiry = 0;
+    rt_atomic_store_explicit(&timer->command, RT_TIMER_STOP,
+                             memory_order_relaxed);
+    rt_atomic_store_explicit(&timer->active, false, memory_order_relaxed);
+    rt_atomic_flag_clear_explicit(&timer->expired, memory_order_relaxed);
+    timer->record.args.timer.timer = timer;
+    timer->record.syscall = RT_SYSCALL_TIMER;
+    rt_atomic_flag_clear_explicit(&timer->command_pending,
+                                  memory_order_release);
+}
+
+static void command(struct rt_timer *timer, enum rt_timer_command cmd)
+{
+    rt_atomic_store_explicit(&timer->command, cmd, memory_order_release);
+    /* If the timer's record is already pending, the system call will see this
+     * command when it runs, so there is no need to use it again. */
+    if (!rt_atomic_flag_test_and_set_explicit(&timer->command_pending,
+                                              memory_order_acquire))
+    {
+        rt_syscall(&timer->record);
+    }
+}
+
+void rt_timer_start(struct rt_timer *timer, unsigned long ticks,
+                    unsigned long period)
+{
+    /* The start command releases these to the system call. If the system call
+     * handles an earlier command in between, it may see only some of them,
+     * but the start command is then handled again with both. */
+    rt_atomic_store_explicit(&timer->ticks, ticks, memory_order_relaxed);
+    rt_atomic_store_explicit(&timer->period, period, memory_order_relaxed);
+    rt_timer_reset(timer);
+}
+
+void rt_timer_reset(struct rt_timer *timer)
+{
+    rt_atomic_store_explicit(&timer->active, true, memory_order_relaxed);
+    command(timer, RT_TIMER_START);
+}
+
+void rt_timer_stop(struct rt_timer *timer)
+{
+    rt_atomic_store_explicit(&timer->active, false, memory_order_relaxed);
+    command(timer, RT_TIMER_STOP);
+}
+
+bool rt_timer_is_active(const struct rt_timer *timer)
+{
+    return rt_atomic_load_explicit(&timer->active, memory_order_relaxed);
+}
+
+void rt_timer_daemon(void)
+{
+    for (;;)
+    {
+        rt_sem_wait(&rt_timer_sem);
+
+        /* The system call handler pushes expired timers onto a stack, so
+         * reverse it to run the callbacks in order of expiry. */
+        struct rt_timer *timer = rt_atomic_exchange_explicit(
+            &rt_timer_expired, NULL, memory_order_acquire);
+        struct rt_timer *in_order = NULL;
+        while (timer != NULL)
+        {
+            struct rt_timer *const next = timer->next_expired;
+            timer->next_expired = in_order;
+            in_order = timer;
+            timer = next;
+        }
+
+        while (in_order != NULL)
+        {
+            timer = in_order;
+            in_order = timer->next_expired;
+            /* Allow the timer to be pushed again once its link has been
+             * read. */
+            rt_atomic_flag_clear_explicit(&timer->expired,
+                                          memory_order_release);
+            rt_logf("%s timer callback\n", rt_task_name());
+            timer->fn(timer->arg);
+        }
+    }
+}
@@ -0,0 +1,15 @@
+#ifndef RT_TIMER_INTERNAL_H
+#define RT_TIMER_INTERNAL_H
+
+#include <muntos/sem.h>
+#include <muntos/timer.h>
+
+/*
+ * Shared by the system call handler and the timer daemon. The handler pushes
+ * expired timers onto the rt_timer_expired stack and posts rt_timer_sem, and
+ * the daemon takes the whole stack and runs each timer's function.
+ */
+extern struct rt_sem rt_timer_sem;
+extern struct rt_timer *_Atomic rt_timer_expired;
+
+#endif /* RT_TIMER_INTERNAL_H */
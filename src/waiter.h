@@ -0,0 +1,88 @@
+#ifndef RT_WAITER_H
+#define RT_WAITER_H
+
+/*
+ * A flag that lets one side of a lock-free object skip posting a semaphore
+ * unless the other side is about to block on it. The blocked side announces
+ * that it is waiting, then checks its condition again before each wait, and
+ * the other side checks the flag after publishing a change. Both sides use a
+ * sequentially consistent fence between their store and their load, so either
+ * the waiter sees the change or the other side sees the flag and posts.
+ */
+
+#include <muntos/atomic.h>
+#include <muntos/sem.h>
+
+#include <stdbool.h>
+
+static inline void rt_waiter_announce(rt_atomic_bool *waiting)
+{
+    rt_atomic_store_explicit(waiting, true, memory_order_relaxed);
+    rt_atomic_thread_fence(memory_order_seq_cst);
+}
+
+/*
+ * Called each time the waiter's condition fails. The first failure only
+ * announces the wait, so that the condition is checked again before blocking,
+ * and each later failure waits for a post and announces again.
+ */
+static inline void rt_waiter_wait(rt_atomic_bool *waiting, struct rt_sem *sem,
+                                  bool *announced)
+{
+    if (*announced)
+    {
+        rt_sem_wait(sem);
+    }
+    rt_waiter_announce(waiting);
+    *announced = true;
+}
+
+/*
+ * Like rt_waiter_wait, but returns false if the timeout expires.
+ */
+static inline bool rt_waiter_timedwait(rt_atomic_bool *waiting,
+                                       struct rt_sem *sem, bool *announced,
+                                       unsigned long start_tick,
+                                       unsigned long ticks)
+{
+    if (*announced && !rt_sem_timedwait_since(sem, start_tick, ticks))
+    {
+        return false;
+    }
+    rt_waiter_announce(waiting);
+    *announced = true;
+    return true;
+}
+
+/*
+ * Clear the flag once the waiter stops waiting, so the other side doesn't
+ * post needlessly.
+ */
+static inline void rt_waiter_done(rt_atomic_bool *waiting, bool announced)
+{
+    if (announced)
+    {
+        rt_atomic_store_explicit(waiting, false, memory_order_relaxed);
+    }
+}
+
+static inline bool rt_waiter_is_waiting(rt_atomic_bool *waiting)
+{
+    rt_atomic_thread_fence(memory_order_seq_cst);
+    return rt_atomic_load_explicit(waiting, memory_order_relaxed);
+}
+
+/*
+ * Post the semaphore if the other side announced that it is waiting. The
+ * exchange ensures that only one post is made for each announcement.
+ */
+static inline void rt_waiter_wake(rt_atomic_bool *waiting, struct rt_sem *sem)
+{
+    if (rt_waiter_is_waiting(waiting) &&
+        rt_atomic_exchange_explicit(waiting, false, memory_order_relaxed))
+    {
+        rt_sem_post(sem);
+    }
+}
+
+#endif /* RT_WAITER_H */
@@ -0,0 +1,74 @@
+#include <muntos/workqueue.h>
+
+#include <muntos/log.h>
+#include <muntos/task.h>
+
+void rt_work_init(struct rt_work *work, void (*fn)(struct rt_work *))
+{
+    work->next = NULL;
+    work->fn = fn;
+    rt_atomic_flag_clear_explicit(&work->pending, memory_order_release);
+}
+
+void rt_workqueue_init(struct rt_workqueue *wq)
+{
+    rt_atomic_store_explicit(&wq->head, NULL, memory_order_relaxed);
+    rt_sem_init_binary(&wq->sem, 0);
+}
+
+bool rt_workqueue_submit(struct rt_workqueue *wq, struct rt_work *work)
+{
+    if (rt_atomic_flag_test_and_set_explicit(&work->pending,
+                                             memory_order_acquire))
+    {
+        return false;
+    }
+    work->next = rt_atomic_load_explicit(&wq->head, memory_order_relaxed);
+    while (!rt_atomic_compare_exchange_weak_explicit(
+        &wq->head, &work->next, work, memory_order_release,
+        memory_order_relaxed))
+    {
+    }
+    /* Only wake a worker when the queue becomes non-empty. Any later
+     * submissions are taken along with this one, or by the worker that takes
+     * the next non-empty queue. */
+    if (work->next == NULL)
+    {
+        rt_sem_post(&wq->sem);
+    }
+    return true;
+}
+
+void rt_workqueue_worker(uintptr_t arg)
+{
+    struct rt_workqueue *const wq = (struct rt_workqueue *)arg;
+    for (;;)
+    {
+        rt_sem_wait(&wq->sem);
+
+        /* Work is pushed onto a stack, so reverse it to run it in order of
+         * submission. */
+        struct rt_work *work =
+            rt_atomic_exchange_explicit(&wq->head, NULL, memory_order_acquire);
+        struct rt_work *in_order = NULL;
+        while (work != NULL)
+        {
+            struct rt_work *const next = work->next;
+            work->next = in_order;
+            in_order = work;
+            work = next;
+        }
+
+        while (in_order != NULL)
+        {
+            work = in_order;
+            in_order = work->next;
+            /* Allow the work to be submitted again once its link has been
+             * read, so a submission during fn isn't lost. */
+            rt_atomic_flag_clear_explicit(&work->pending,
+                                          memory_order_release);
+            rt_logf("%s running work\n", rt_task_name());
+            work->fn(work);
+        }
+    }
+}
@@ -8,16 +8,36 @@ trap 'if [ "$?" != "0" ]; then echo "test failed!"; fi' EXIT
 
 set -x
 
+build/basic
+build/broadcast
+build/coro
+build/event_group
 build/list
+build/mailbox
+build/message_buffer
+build/mpmc_queue
 build/mutex
 build/newtask
 build/once
 build/pq
+build/prio_queue
+build/priority
 build/queue
+build/rcu
+build/reserve
 build/rwlock
+build/sched_lock
+build/select
+build/seqlock
 build/sem
 build/simple
 build/sleep
+build/spsc_queue
+build/stream_buffer
+build/suspend
+build/task_notify
+build/timer
+build/workqueue
 build/water/barrier
 build/water/cond
 build/water/sem